@@ -0,0 +1,156 @@
+// src/http/Compression.cpp
+#include "Compression.h"
+#include "RequestParser.h"
+#include "../utils/Arena.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+#ifdef HAVE_ZLIB
+    #include <zlib.h>
+#endif
+
+std::pmr::vector<ContentEncoding> Compression::parseAcceptEncoding(std::string_view acceptEncoding) {
+    struct Candidate {
+        ContentEncoding encoding;
+        double quality;
+    };
+    std::pmr::vector<Candidate> candidates(RequestArena::current());
+    double wildcard = -1.0;
+
+    size_t pos = 0;
+    while (pos < acceptEncoding.size()) {
+        size_t comma = acceptEncoding.find(',', pos);
+        if (comma == std::string_view::npos) comma = acceptEncoding.size();
+        std::string_view item = acceptEncoding.substr(pos, comma - pos);
+        pos = comma + 1;
+
+        // Split "gzip;q=0.8" into coding and quality
+        double quality = 1.0;
+        size_t semicolon = item.find(';');
+        if (semicolon != std::string_view::npos) {
+            size_t q = item.find("q=", semicolon);
+            if (q != std::string_view::npos) {
+                // Short and bounded by the next parameter, so it fits a buffer
+                char number[16] = {};
+                std::string_view digits = item.substr(q + 2, item.find(';', q) - q - 2);
+                digits.copy(number, std::min(digits.size(), sizeof(number) - 1));
+                quality = std::atof(number);
+            }
+            item = item.substr(0, semicolon);
+        }
+
+        while (!item.empty() && isspace(static_cast<unsigned char>(item.front()))) item.remove_prefix(1);
+        while (!item.empty() && isspace(static_cast<unsigned char>(item.back()))) item.remove_suffix(1);
+
+        auto is = [item](std::string_view name) { return RequestParser::equalsIgnoreCase(item, name); };
+        if (is("br")) candidates.push_back({ContentEncoding::BROTLI, quality});
+        else if (is("gzip") || is("x-gzip")) candidates.push_back({ContentEncoding::GZIP, quality});
+        else if (is("deflate")) candidates.push_back({ContentEncoding::DEFLATE, quality});
+        else if (is("identity")) candidates.push_back({ContentEncoding::IDENTITY, quality});
+        else if (item == "*") wildcard = quality;
+    }
+
+    // "*" stands for every coding not listed explicitly
+    if (wildcard >= 0.0) {
+        for (ContentEncoding encoding : {ContentEncoding::BROTLI, ContentEncoding::GZIP, ContentEncoding::DEFLATE}) {
+            bool listed = std::any_of(candidates.begin(), candidates.end(),
+                                      [encoding](const Candidate& c) { return c.encoding == encoding; });
+            if (!listed) candidates.push_back({encoding, wildcard});
+        }
+    }
+
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                    [](const Candidate& c) { return c.quality <= 0.0; }),
+                     candidates.end());
+    auto serverRank = [](ContentEncoding encoding) {
+        switch (encoding) {
+            case ContentEncoding::BROTLI: return 0;
+            case ContentEncoding::GZIP: return 1;
+            case ContentEncoding::DEFLATE: return 2;
+            default: return 3;
+        }
+    };
+    // Entries that tie on both keys name the same coding, so an unstable
+    // sort gives the same result without stable_sort's scratch buffer
+    std::sort(candidates.begin(), candidates.end(), [&](const Candidate& a, const Candidate& b) {
+        if (a.quality != b.quality) return a.quality > b.quality;
+        return serverRank(a.encoding) < serverRank(b.encoding);
+    });
+
+    std::pmr::vector<ContentEncoding> result(RequestArena::current());
+    result.reserve(candidates.size());
+    for (const auto& candidate : candidates) {
+        result.push_back(candidate.encoding);
+    }
+    return result;
+}
+
+bool Compression::canCompress(ContentEncoding encoding) {
+    #ifdef HAVE_ZLIB
+        return encoding == ContentEncoding::GZIP || encoding == ContentEncoding::DEFLATE;
+    #else
+        (void)encoding;
+        return false;
+    #endif
+}
+
+bool Compression::compress(const std::string& input, ContentEncoding encoding,
+                           std::string& output, int level) {
+    #ifdef HAVE_ZLIB
+        if (!canCompress(encoding)) {
+            return false;
+        }
+
+        // windowBits 15 + 16 selects the gzip wrapper, plain 15 the zlib one
+        // that HTTP calls "deflate"
+        int windowBits = encoding == ContentEncoding::GZIP ? 15 + 16 : 15;
+
+        z_stream stream{};
+        if (deflateInit2(&stream, level, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            return false;
+        }
+
+        output.resize(deflateBound(&stream, input.size()));
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+        stream.avail_in = static_cast<uInt>(input.size());
+        stream.next_out = reinterpret_cast<Bytef*>(&output[0]);
+        stream.avail_out = static_cast<uInt>(output.size());
+
+        int result = deflate(&stream, Z_FINISH);
+        output.resize(stream.total_out);
+        deflateEnd(&stream);
+        return result == Z_STREAM_END;
+    #else
+        (void)input;
+        (void)encoding;
+        (void)output;
+        (void)level;
+        return false;
+    #endif
+}
+
+bool Compression::isCompressible(const std::string& mimeType) {
+    return mimeType.compare(0, 5, "text/") == 0 ||
+           mimeType == "application/javascript" ||
+           mimeType == "application/json" ||
+           mimeType == "application/xml" ||
+           mimeType == "image/svg+xml";
+}
+
+const char* Compression::getName(ContentEncoding encoding) {
+    switch (encoding) {
+        case ContentEncoding::GZIP: return "gzip";
+        case ContentEncoding::DEFLATE: return "deflate";
+        case ContentEncoding::BROTLI: return "br";
+        default: return "identity";
+    }
+}
+
+const char* Compression::getFileSuffix(ContentEncoding encoding) {
+    switch (encoding) {
+        case ContentEncoding::GZIP: return ".gz";
+        case ContentEncoding::BROTLI: return ".br";
+        default: return "";
+    }
+}
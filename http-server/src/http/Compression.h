@@ -0,0 +1,31 @@
+// src/http/Compression.h
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory_resource>
+
+enum class ContentEncoding {
+    IDENTITY,
+    GZIP,
+    DEFLATE,
+    BROTLI
+};
+
+class Compression {
+public:
+    // Encodings acceptable to the client, most preferred first. Ties on q
+    // are broken by server preference (br, gzip, deflate, identity). The
+    // list is allocated from the request arena.
+    static std::pmr::vector<ContentEncoding> parseAcceptEncoding(std::string_view acceptEncoding);
+
+    // Whether the server can produce this encoding on the fly
+    static bool canCompress(ContentEncoding encoding);
+    static bool compress(const std::string& input, ContentEncoding encoding,
+                         std::string& output, int level = 6);
+
+    static bool isCompressible(const std::string& mimeType);
+
+    static const char* getName(ContentEncoding encoding);
+    static const char* getFileSuffix(ContentEncoding encoding);
+};
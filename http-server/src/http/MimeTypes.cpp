@@ -0,0 +1,241 @@
+// src/http/MimeTypes.cpp
+#include "MimeTypes.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace {
+
+struct MimeEntry {
+    std::string_view extension;     // Lowercase, without the dot
+    std::string_view type;
+};
+
+constexpr MimeEntry MIME_ENTRIES[] = {
+    // Text and documents
+    {"html", "text/html"},
+    {"htm", "text/html"},
+    {"css", "text/css"},
+    {"js", "application/javascript"},
+    {"mjs", "application/javascript"},
+    {"json", "application/json"},
+    {"jsonld", "application/ld+json"},
+    {"map", "application/json"},
+    {"webmanifest", "application/manifest+json"},
+    {"txt", "text/plain"},
+    {"csv", "text/csv"},
+    {"md", "text/markdown"},
+    {"ics", "text/calendar"},
+    {"vtt", "text/vtt"},
+    {"xml", "application/xml"},
+    {"rss", "application/rss+xml"},
+    {"atom", "application/atom+xml"},
+    {"yaml", "application/yaml"},
+    {"yml", "application/yaml"},
+    {"pdf", "application/pdf"},
+    {"rtf", "application/rtf"},
+    {"epub", "application/epub+zip"},
+    {"wasm", "application/wasm"},
+
+    // Images
+    {"png", "image/png"},
+    {"apng", "image/apng"},
+    {"jpg", "image/jpeg"},
+    {"jpeg", "image/jpeg"},
+    {"gif", "image/gif"},
+    {"svg", "image/svg+xml"},
+    {"ico", "image/x-icon"},
+    {"webp", "image/webp"},
+    {"avif", "image/avif"},
+    {"bmp", "image/bmp"},
+    {"tif", "image/tiff"},
+    {"tiff", "image/tiff"},
+
+    // Fonts
+    {"woff", "font/woff"},
+    {"woff2", "font/woff2"},
+    {"ttf", "font/ttf"},
+    {"otf", "font/otf"},
+    {"eot", "application/vnd.ms-fontobject"},
+
+    // Audio and video
+    {"mp4", "video/mp4"},
+    {"m4v", "video/mp4"},
+    {"webm", "video/webm"},
+    {"ogv", "video/ogg"},
+    {"mov", "video/quicktime"},
+    {"mp3", "audio/mpeg"},
+    {"m4a", "audio/mp4"},
+    {"aac", "audio/aac"},
+    {"ogg", "audio/ogg"},
+    {"oga", "audio/ogg"},
+    {"opus", "audio/opus"},
+    {"wav", "audio/wav"},
+    {"flac", "audio/flac"},
+
+    // Archives
+    {"zip", "application/zip"},
+    {"gz", "application/gzip"},
+    {"tar", "application/x-tar"},
+    {"bz2", "application/x-bzip2"},
+    {"xz", "application/x-xz"},
+    {"7z", "application/x-7z-compressed"},
+};
+
+constexpr size_t ENTRY_COUNT = sizeof(MIME_ENTRIES) / sizeof(MIME_ENTRIES[0]);
+constexpr size_t MAX_EXTENSION = 16;
+
+// Sparse enough that a collision-free seed turns up within a few dozen
+// tries, small enough to stay in a handful of cache lines
+constexpr size_t SLOT_COUNT = 512;
+static_assert((SLOT_COUNT & (SLOT_COUNT - 1)) == 0, "slot count must be a power of two");
+static_assert(ENTRY_COUNT < 255, "slots hold an 8-bit entry index");
+
+constexpr char toLower(char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// FNV-1a over the lowercased bytes, with a final mix so the low bits used
+// for the slot depend on every byte
+constexpr size_t slotFor(std::string_view extension, uint32_t seed) {
+    uint32_t hash = 2166136261u ^ seed;
+    for (char c : extension) {
+        hash ^= static_cast<unsigned char>(toLower(c));
+        hash *= 16777619u;
+    }
+    hash ^= hash >> 15;
+    hash *= 0x2c1b3c6du;
+    hash ^= hash >> 12;
+    return hash & (SLOT_COUNT - 1);
+}
+
+constexpr bool isPerfect(uint32_t seed) {
+    std::array<bool, SLOT_COUNT> used{};
+    for (const auto& entry : MIME_ENTRIES) {
+        size_t slot = slotFor(entry.extension, seed);
+        if (used[slot]) {
+            return false;
+        }
+        used[slot] = true;
+    }
+    return true;
+}
+
+constexpr uint32_t findSeed() {
+    for (uint32_t seed = 1; seed < 100000; ++seed) {
+        if (isPerfect(seed)) {
+            return seed;
+        }
+    }
+    return 0;
+}
+
+constexpr uint32_t SEED = findSeed();
+static_assert(SEED != 0, "no collision-free seed for the MIME table; grow SLOT_COUNT");
+
+// Slot to entry index + 1, 0 for an empty slot
+constexpr std::array<uint8_t, SLOT_COUNT> buildSlots() {
+    std::array<uint8_t, SLOT_COUNT> slots{};
+    for (size_t i = 0; i < ENTRY_COUNT; ++i) {
+        slots[slotFor(MIME_ENTRIES[i].extension, SEED)] = static_cast<uint8_t>(i + 1);
+    }
+    return slots;
+}
+
+constexpr std::array<uint8_t, SLOT_COUNT> SLOTS = buildSlots();
+
+constexpr bool equalsLower(std::string_view lower, std::string_view text) {
+    if (lower.size() != text.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (lower[i] != toLower(text[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+constexpr std::string_view findBuiltIn(std::string_view extension) {
+    uint8_t index = SLOTS[slotFor(extension, SEED)];
+    if (index == 0 || !equalsLower(MIME_ENTRIES[index - 1].extension, extension)) {
+        return {};
+    }
+    return MIME_ENTRIES[index - 1].type;
+}
+
+static_assert(findBuiltIn("woff2") == "font/woff2", "MIME table lookup");
+static_assert(findBuiltIn("PNG") == "image/png", "MIME table lookup is case-insensitive");
+static_assert(findBuiltIn("unknown").empty(), "MIME table lookup miss");
+
+std::string_view stripDot(std::string_view extension) {
+    if (!extension.empty() && extension[0] == '.') {
+        extension.remove_prefix(1);
+    }
+    return extension;
+}
+
+} // namespace
+
+std::vector<std::pair<std::string, std::string>>& MimeTypes::overrides() {
+    // Sorted by lowercase extension
+    static std::vector<std::pair<std::string, std::string>> table;
+    return table;
+}
+
+std::string_view MimeTypes::find(std::string_view extension) {
+    extension = stripDot(extension);
+    if (extension.empty() || extension.size() > MAX_EXTENSION) {
+        return {};
+    }
+
+    const auto& extra = overrides();
+    if (!extra.empty()) {
+        char lower[MAX_EXTENSION];
+        for (size_t i = 0; i < extension.size(); ++i) {
+            lower[i] = toLower(extension[i]);
+        }
+        std::string_view key(lower, extension.size());
+        auto it = std::lower_bound(extra.begin(), extra.end(), key,
+                                   [](const auto& item, std::string_view k) { return std::string_view(item.first) < k; });
+        if (it != extra.end() && it->first == key) {
+            return it->second;
+        }
+    }
+    return findBuiltIn(extension);
+}
+
+std::string_view MimeTypes::forPath(std::string_view path) {
+    size_t dotPos = path.find_last_of('.');
+    size_t slashPos = path.find_last_of('/');
+    if (dotPos == std::string_view::npos || (slashPos != std::string_view::npos && dotPos < slashPos)) {
+        return DEFAULT_TYPE;
+    }
+    std::string_view type = find(path.substr(dotPos + 1));
+    return type.empty() ? DEFAULT_TYPE : type;
+}
+
+void MimeTypes::add(std::string_view extension, std::string_view type) {
+    extension = stripDot(extension);
+    if (extension.empty() || extension.size() > MAX_EXTENSION || type.empty()) {
+        return;
+    }
+    std::string key;
+    for (char c : extension) {
+        key += toLower(c);
+    }
+
+    auto& extra = overrides();
+    auto it = std::lower_bound(extra.begin(), extra.end(), key,
+                               [](const auto& item, const std::string& k) { return item.first < k; });
+    if (it != extra.end() && it->first == key) {
+        it->second = std::string(type);
+    } else {
+        extra.emplace(it, std::move(key), std::string(type));
+    }
+}
+
+void MimeTypes::clearOverrides() {
+    overrides().clear();
+}
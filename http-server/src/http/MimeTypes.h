@@ -0,0 +1,29 @@
+// src/http/MimeTypes.h
+#pragma once
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Extension to Content-Type mapping. The built-in table is a perfect hash
+// generated at compile time, so a lookup is one hash and one compare and
+// never allocates. Extensions match case-insensitively, with or without
+// the leading dot.
+class MimeTypes {
+public:
+    static constexpr std::string_view DEFAULT_TYPE = "application/octet-stream";
+
+    // Empty if the extension is unknown
+    static std::string_view find(std::string_view extension);
+
+    // Type for the extension of the last path segment, DEFAULT_TYPE if none
+    static std::string_view forPath(std::string_view path);
+
+    // Adds or replaces a mapping, taking precedence over the built-in table.
+    // Not thread-safe; call during startup, before any lookup.
+    static void add(std::string_view extension, std::string_view type);
+    static void clearOverrides();
+
+private:
+    static std::vector<std::pair<std::string, std::string>>& overrides();
+};
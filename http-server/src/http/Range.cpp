@@ -0,0 +1,103 @@
+// src/http/Range.cpp
+#include "Range.h"
+#include <algorithm>
+#include <cctype>
+
+namespace {
+
+bool parseNumber(const std::string& str, size_t& value) {
+    if (str.empty() || str.size() > 19) {
+        return false;
+    }
+    value = 0;
+    for (char c : str) {
+        if (!isdigit(static_cast<unsigned char>(c))) {
+            return false;
+        }
+        value = value * 10 + static_cast<size_t>(c - '0');
+    }
+    return true;
+}
+
+std::string trim(const std::string& str) {
+    size_t first = str.find_first_not_of(" \t");
+    if (first == std::string::npos) return "";
+    size_t last = str.find_last_not_of(" \t");
+    return str.substr(first, last - first + 1);
+}
+
+}
+
+RangeResult Range::parse(std::string_view header, size_t totalSize,
+                         std::vector<ByteRange>& ranges, size_t maxRanges) {
+    ranges.clear();
+
+    std::string value = trim(std::string(header));
+    if (value.compare(0, 6, "bytes=") != 0) {
+        return RangeResult::IGNORE;
+    }
+
+    size_t specCount = 0;
+    size_t pos = 6;
+    while (pos <= value.size()) {
+        size_t comma = value.find(',', pos);
+        if (comma == std::string::npos) comma = value.size();
+        std::string spec = trim(value.substr(pos, comma - pos));
+        pos = comma + 1;
+
+        if (spec.empty()) {
+            continue;
+        }
+        if (++specCount > maxRanges) {
+            // Lots of tiny ranges are a classic amplification trick
+            return RangeResult::IGNORE;
+        }
+
+        size_t dash = spec.find('-');
+        if (dash == std::string::npos) {
+            return RangeResult::IGNORE;
+        }
+        std::string firstStr = spec.substr(0, dash);
+        std::string lastStr = spec.substr(dash + 1);
+
+        size_t first = 0;
+        size_t last = 0;
+        if (firstStr.empty()) {
+            // Suffix range: the final N bytes
+            size_t suffix = 0;
+            if (!parseNumber(lastStr, suffix)) {
+                return RangeResult::IGNORE;
+            }
+            if (suffix == 0 || totalSize == 0) {
+                continue;
+            }
+            first = totalSize - std::min(suffix, totalSize);
+            last = totalSize - 1;
+        } else {
+            if (!parseNumber(firstStr, first)) {
+                return RangeResult::IGNORE;
+            }
+            if (lastStr.empty()) {
+                last = totalSize - 1;
+            } else if (!parseNumber(lastStr, last) || last < first) {
+                return RangeResult::IGNORE;
+            }
+            if (first >= totalSize) {
+                continue;
+            }
+            last = std::min(last, totalSize - 1);
+        }
+
+        ranges.push_back({first, last});
+    }
+
+    if (specCount == 0) {
+        return RangeResult::IGNORE;
+    }
+    return ranges.empty() ? RangeResult::UNSATISFIABLE : RangeResult::SATISFIABLE;
+}
+
+std::string Range::formatContentRange(const ByteRange& range, size_t totalSize) {
+    return "bytes " + std::to_string(range.first) + "-" + std::to_string(range.last) + "/" +
+           std::to_string(totalSize);
+}
@@ -0,0 +1,30 @@
+// src/http/Range.h
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+// An inclusive byte range resolved against a representation length
+struct ByteRange {
+    size_t first;
+    size_t last;
+
+    size_t length() const { return last - first + 1; }
+};
+
+enum class RangeResult {
+    IGNORE,             // Missing, malformed or not worth honoring: send 200
+    SATISFIABLE,
+    UNSATISFIABLE       // Well-formed but outside the representation: 416
+};
+
+class Range {
+public:
+    // Parses a "bytes=..." Range header value against a representation of
+    // totalSize bytes, dropping unsatisfiable specs as RFC 7233 requires
+    static RangeResult parse(std::string_view header, size_t totalSize,
+                             std::vector<ByteRange>& ranges, size_t maxRanges = 16);
+
+    static std::string formatContentRange(const ByteRange& range, size_t totalSize);
+};
@@ -1,129 +1,157 @@
-// src/http/Request.cpp
-#include "Request.h"
-#include <iostream>
-
-bool HttpRequest::parse(const std::string& rawRequest) {
-    std::istringstream requestStream(rawRequest);
-    std::string line;
-    
-    // Parse request line
-    if (!std::getline(requestStream, line)) {
-        return false;
-    }
-    
-    std::istringstream lineStream(line);
-    std::string methodStr, fullPath;
-    lineStream >> methodStr >> fullPath >> version;
-    
-    method = stringToMethod(methodStr);
-    
-    // Separate path and query string
-    size_t queryPos = fullPath.find('?');
-    if (queryPos != std::string::npos) {
-        path = fullPath.substr(0, queryPos);
-        std::string query = fullPath.substr(queryPos + 1);
-        parseQueryString(query);
-    } else {
-        path = fullPath;
-    }
-    
-    // Parse headers
-    while (std::getline(requestStream, line) && line != "\r" && line != "") {
-        size_t colonPos = line.find(':');
-        if (colonPos != std::string::npos) {
-            std::string key = line.substr(0, colonPos);
-            std::string value = line.substr(colonPos + 2); // Skip ": "
-            
-            // Remove trailing \r
-            if (!value.empty() && value.back() == '\r') {
-                value.pop_back();
-            }
-            
-            headers[key] = value;
-        }
-    }
-    
-    // Parse body
-    if (getContentLength() > 0) {
-        size_t contentLen = getContentLength();
-        char* bodyBuffer = new char[contentLen + 1];
-        requestStream.read(bodyBuffer, contentLen);
-        bodyBuffer[contentLen] = '\0';
-        body = std::string(bodyBuffer);
-        delete[] bodyBuffer;
-    }
-    
-    return true;
-}
-
-void HttpRequest::parseQueryString(const std::string& query) {
-    std::istringstream queryStream(query);
-    std::string pair;
-    
-    while (std::getline(queryStream, pair, '&')) {
-        size_t equalPos = pair.find('=');
-        if (equalPos != std::string::npos) {
-            std::string key = pair.substr(0, equalPos);
-            std::string value = pair.substr(equalPos + 1);
-            queryParams[urlDecode(key)] = urlDecode(value);
-        }
-    }
-}
-
-std::string HttpRequest::getHeader(const std::string& key) const {
-    auto it = headers.find(key);
-    if (it != headers.end()) {
-        return it->second;
-    }
-    return "";
-}
-
-std::string HttpRequest::getContentType() const {
-    return getHeader("Content-Type");
-}
-
-size_t HttpRequest::getContentLength() const {
-    std::string cl = getHeader("Content-Length");
-    if (!cl.empty()) {
-        try {
-            return std::stoul(cl);
-        } catch (...) {
-            return 0;
-        }
-    }
-    return 0;
-}
-
-std::string HttpRequest::getQueryParam(const std::string& key) const {
-    auto it = queryParams.find(key);
-    if (it != queryParams.end()) {
-        return it->second;
-    }
-    return "";
-}
-
-HttpMethod HttpRequest::stringToMethod(const std::string& str) {
-    if (str == "GET") return HttpMethod::GET;
-    if (str == "POST") return HttpMethod::POST;
-    if (str == "HEAD") return HttpMethod::HEAD;
-    if (str == "PUT") return HttpMethod::PUT;
-    if (str == "DELETE") return HttpMethod::DELETE;
-    return HttpMethod::UNKNOWN;
-}
-
-std::string HttpRequest::urlDecode(const std::string& str) {
-    std::string result;
-    for (size_t i = 0; i < str.length(); ++i) {
-        if (str[i] == '%' && i + 2 < str.length()) {
-            std::string hex = str.substr(i + 1, 2);
-            char ch = static_cast<char>(std::stoi(hex, nullptr, 16));
-            result += ch;
-            i += 2;
-        } else if (str[i] == '+') {
-            result += ' ';
-        } else {
-            result += str[i];
-        }
-    }
-    return result;
-}
\ No newline at end of file
+// src/http/Request.cpp
+#include "Request.h"
+#include <cctype>
+
+bool HttpRequest::parse(std::string rawRequest) {
+    RequestParser parser;
+    if (parser.parse(rawRequest.data(), rawRequest.size()) != RequestParser::Status::COMPLETE) {
+        return false;
+    }
+    assign(std::move(rawRequest), std::move(parser.getLayout()));
+    return true;
+}
+
+void HttpRequest::assign(std::string rawRequest, RequestLayout requestLayout) {
+    raw = std::move(rawRequest);
+    layout = std::move(requestLayout);
+    joinedBody.clear();
+    method = stringToMethod(getMethodName());
+    
+    // Separate path and query string
+    path = layout.target;
+    query = Span();
+    std::string_view target = layout.target.in(raw.data());
+    size_t queryPos = target.find('?');
+    if (queryPos != std::string_view::npos) {
+        path.length = queryPos;
+        query.offset = layout.target.offset + queryPos + 1;
+        query.length = target.size() - queryPos - 1;
+    }
+}
+
+std::string_view HttpRequest::getHeader(HeaderId id) const {
+    if (id == HeaderId::UNKNOWN) {
+        return std::string_view();
+    }
+    uint16_t slot = layout.known[static_cast<size_t>(id)];
+    return slot == 0 ? std::string_view() : layout.headers[slot - 1].value.in(raw.data());
+}
+
+std::string_view HttpRequest::getHeader(std::string_view key) const {
+    HeaderId id = RequestParser::identifyHeader(key);
+    if (id != HeaderId::UNKNOWN) {
+        return getHeader(id);
+    }
+    for (const auto& field : layout.headers) {
+        if (field.id == HeaderId::UNKNOWN && RequestParser::equalsIgnoreCase(field.name.in(raw.data()), key)) {
+            return field.value.in(raw.data());
+        }
+    }
+    return std::string_view();
+}
+
+std::string_view HttpRequest::getBody() const {
+    if (layout.bodyChunks.empty()) {
+        return std::string_view();
+    }
+    if (layout.bodyChunks.size() == 1) {
+        return layout.bodyChunks[0].in(raw.data());
+    }
+    if (joinedBody.empty()) {
+        joinedBody.reserve(layout.contentLength);
+        for (const auto& chunk : layout.bodyChunks) {
+            joinedBody.append(raw.data() + chunk.offset, chunk.length);
+        }
+    }
+    return joinedBody;
+}
+
+std::vector<std::string_view> HttpRequest::getBodyChunks() const {
+    std::vector<std::string_view> chunks;
+    chunks.reserve(layout.bodyChunks.size());
+    for (const auto& chunk : layout.bodyChunks) {
+        chunks.push_back(chunk.in(raw.data()));
+    }
+    return chunks;
+}
+
+std::string_view HttpRequest::getContentType() const {
+    return getHeader(HeaderId::CONTENT_TYPE);
+}
+
+bool HttpRequest::isKeepAlive() const {
+    // HTTP/1.1 connections are persistent unless the client opts out;
+    // HTTP/1.0 clients have to ask for it explicitly
+    if (getVersion() == "HTTP/1.1") {
+        return !layout.connectionClose;
+    }
+    return layout.connectionKeepAlive && !layout.connectionClose;
+}
+
+std::string HttpRequest::getQueryParam(std::string_view key) const {
+    // Query strings are short; scanning them beats building a map per request
+    std::string_view remaining = query.in(raw.data());
+    while (!remaining.empty()) {
+        size_t ampPos = remaining.find('&');
+        std::string_view pair = remaining.substr(0, ampPos);
+        remaining = ampPos == std::string_view::npos ? std::string_view() : remaining.substr(ampPos + 1);
+        
+        size_t equalPos = pair.find('=');
+        if (equalPos != std::string_view::npos && urlDecode(pair.substr(0, equalPos)) == key) {
+            return urlDecode(pair.substr(equalPos + 1));
+        }
+    }
+    return "";
+}
+
+HttpMethod HttpRequest::stringToMethod(std::string_view str) {
+    if (str == "GET") return HttpMethod::GET;
+    if (str == "POST") return HttpMethod::POST;
+    if (str == "HEAD") return HttpMethod::HEAD;
+    if (str == "PUT") return HttpMethod::PUT;
+    if (str == "DELETE") return HttpMethod::DELETE;
+    if (str == "OPTIONS") return HttpMethod::OPTIONS;
+    if (str == "PATCH") return HttpMethod::PATCH;
+    return HttpMethod::UNKNOWN;
+}
+
+const char* HttpRequest::methodToString(HttpMethod method) {
+    switch (method) {
+        case HttpMethod::GET: return "GET";
+        case HttpMethod::POST: return "POST";
+        case HttpMethod::HEAD: return "HEAD";
+        case HttpMethod::PUT: return "PUT";
+        case HttpMethod::DELETE: return "DELETE";
+        case HttpMethod::OPTIONS: return "OPTIONS";
+        case HttpMethod::PATCH: return "PATCH";
+        default: return "UNKNOWN";
+    }
+}
+
+time_t HttpRequest::parseHttpDate(std::string_view str) {
+    std::string value(str);
+    struct tm timeinfo = {};
+    const char* end = strptime(value.c_str(), "%a, %d %b %Y %H:%M:%S GMT", &timeinfo);
+    if (end == nullptr) {
+        return -1;
+    }
+    return timegm(&timeinfo);
+}
+
+std::string HttpRequest::urlDecode(std::string_view str) {
+    std::string result;
+    result.reserve(str.size());
+    for (size_t i = 0; i < str.length(); ++i) {
+        if (str[i] == '%' && i + 2 < str.length() &&
+            isxdigit(static_cast<unsigned char>(str[i + 1])) && isxdigit(static_cast<unsigned char>(str[i + 2]))) {
+            char hex[3] = {str[i + 1], str[i + 2], '\0'};
+            result += static_cast<char>(strtol(hex, nullptr, 16));
+            i += 2;
+        } else if (str[i] == '+') {
+            result += ' ';
+        } else {
+            result += str[i];
+        }
+    }
+    return result;
+}
@@ -1,48 +1,67 @@
-// src/http/Request.h
-#pragma once
-#include <string>
-#include <unordered_map>
-#include <vector>
-#include <sstream>
-#include <algorithm>
-
-enum class HttpMethod {
-    GET,
-    POST,
-    HEAD,
-    PUT,
-    DELETE,
-    UNKNOWN
-};
-
-class HttpRequest {
-private:
-    HttpMethod method;
-    std::string path;
-    std::string version;
-    std::unordered_map<std::string, std::string> headers;
-    std::string body;
-    std::unordered_map<std::string, std::string> queryParams;
-    
-    void parseQueryString(const std::string& query);
-    
-public:
-    HttpRequest() : method(HttpMethod::UNKNOWN) {}
-    
-    bool parse(const std::string& rawRequest);
-    
-    // Getters
-    HttpMethod getMethod() const { return method; }
-    std::string getPath() const { return path; }
-    std::string getVersion() const { return version; }
-    std::string getHeader(const std::string& key) const;
-    std::string getBody() const { return body; }
-    
-    // Utility
-    std::string getContentType() const;
-    size_t getContentLength() const;
-    std::string getQueryParam(const std::string& key) const;
-    
-    static HttpMethod stringToMethod(const std::string& str);
-    static std::string urlDecode(const std::string& str);
-};
\ No newline at end of file
+// src/http/Request.h
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <ctime>
+#include "RequestParser.h"
+
+enum class HttpMethod {
+    GET,
+    POST,
+    HEAD,
+    PUT,
+    DELETE,
+    OPTIONS,
+    PATCH,
+    UNKNOWN     // Also the number of known methods
+};
+
+// A parsed request. The raw bytes are owned by the request and every
+// accessor returns a view into them, so nothing is copied per header.
+class HttpRequest {
+private:
+    std::string raw;
+    RequestLayout layout;
+    HttpMethod method;
+    Span path;
+    Span query;
+    
+    // A chunked body joined into one piece, built on first use of getBody()
+    mutable std::string joinedBody;
+    
+public:
+    HttpRequest() : method(HttpMethod::UNKNOWN) {}
+    
+    // Parses a complete request from scratch
+    bool parse(std::string rawRequest);
+    
+    // Takes a request already framed by a RequestParser
+    void assign(std::string rawRequest, RequestLayout requestLayout);
+    
+    // Getters
+    HttpMethod getMethod() const { return method; }
+    std::string_view getMethodName() const { return layout.method.in(raw.data()); }
+    std::string_view getPath() const { return path.in(raw.data()); }
+    std::string_view getVersion() const { return layout.version.in(raw.data()); }
+    std::string_view getHeader(HeaderId id) const;
+    std::string_view getHeader(std::string_view key) const;     // Case-insensitive
+    std::string_view getBody() const;
+    
+    // The body in the pieces it arrived in, without joining chunked bodies
+    std::vector<std::string_view> getBodyChunks() const;
+    
+    // Utility
+    std::string_view getContentType() const;
+    size_t getContentLength() const { return layout.contentLength; }
+    std::string getQueryParam(std::string_view key) const;
+    bool isKeepAlive() const;
+    
+    static HttpMethod stringToMethod(std::string_view str);
+    static const char* methodToString(HttpMethod method);
+    static std::string urlDecode(std::string_view str);
+    
+    // Parses an IMF-fixdate; returns -1 if the value is malformed
+    static time_t parseHttpDate(std::string_view str);
+};
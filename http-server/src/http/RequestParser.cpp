@@ -0,0 +1,556 @@
+// src/http/RequestParser.cpp
+#include "RequestParser.h"
+#include "Scanner.h"
+#include <cctype>
+
+namespace {
+
+// Indexed by HeaderId
+const std::string_view HEADER_NAMES[] = {
+    "Host",
+    "Connection",
+    "Content-Length",
+    "Content-Type",
+    "Transfer-Encoding",
+    "Expect",
+    "Accept",
+    "Accept-Encoding",
+    "Range",
+    "If-Range",
+    "If-None-Match",
+    "If-Modified-Since",
+    "User-Agent",
+    "Referer",
+    "Origin",
+    "Cookie",
+    "Authorization",
+};
+
+static_assert(sizeof(HEADER_NAMES) / sizeof(HEADER_NAMES[0]) == static_cast<size_t>(HeaderId::UNKNOWN),
+              "HEADER_NAMES must list every HeaderId");
+
+// Typical requests carry fewer headers than this, so the list is
+// allocated once instead of growing a step at a time
+constexpr size_t EXPECTED_HEADERS = 16;
+
+// Applies one Connection header, a comma-separated list of options
+void parseConnection(std::string_view value, RequestLayout& layout) {
+    while (!value.empty()) {
+        size_t comma = value.find(',');
+        std::string_view token = value.substr(0, comma);
+        value = comma == std::string_view::npos ? std::string_view() : value.substr(comma + 1);
+
+        while (!token.empty() && (token.front() == ' ' || token.front() == '\t')) {
+            token.remove_prefix(1);
+        }
+        while (!token.empty() && (token.back() == ' ' || token.back() == '\t')) {
+            token.remove_suffix(1);
+        }
+        if (RequestParser::equalsIgnoreCase(token, "close")) {
+            layout.connectionClose = true;
+        } else if (RequestParser::equalsIgnoreCase(token, "keep-alive")) {
+            layout.connectionKeepAlive = true;
+        }
+    }
+}
+
+} // namespace
+
+void RequestParser::setLimits(size_t headerSize, size_t headerCount, size_t bodySize) {
+    maxHeaderSize = headerSize;
+    maxHeaderCount = headerCount;
+    maxBodySize = bodySize;
+}
+
+void RequestParser::reset() {
+    layout = RequestLayout();
+    state = State::START;
+    status = Status::INCOMPLETE;
+    pos = 0;
+    errorStatus = 0;
+    messageLength = 0;
+    hostCount = 0;
+    hasContentLength = false;
+    isHttp11 = false;
+    chunked = false;
+    expectContinue = false;
+    chunkSize = 0;
+    chunkDigits = 0;
+    chunkStart = 0;
+    chunkEnd = 0;
+    trailerStart = 0;
+}
+
+RequestParser::Status RequestParser::fail(int code) {
+    errorStatus = code;
+    status = Status::ERROR;
+    return status;
+}
+
+RequestParser::Status RequestParser::parse(const char* data, size_t size) {
+    if (status != Status::INCOMPLETE) {
+        return status;
+    }
+
+    while (state < State::BODY) {
+        if (pos >= size) {
+            return Status::INCOMPLETE;
+        }
+        if (pos >= maxHeaderSize) {
+            return fail(state == State::METHOD || state == State::TARGET ? 414 : 431);
+        }
+
+        size_t limit = size < maxHeaderSize ? size : maxHeaderSize;
+        unsigned char c = static_cast<unsigned char>(data[pos]);
+        switch (state) {
+            case State::START:
+                // Stray line breaks between pipelined requests are tolerated
+                if (c == '\r' || c == '\n') {
+                    pos++;
+                    break;
+                }
+                layout.method.offset = pos;
+                state = State::METHOD;
+                break;
+
+            case State::METHOD:
+                if (Scanner::isTokenChar(c)) {
+                    pos++;
+                } else if (c == ' ' && pos > layout.method.offset) {
+                    layout.method.length = pos - layout.method.offset;
+                    layout.target.offset = ++pos;
+                    state = State::TARGET;
+                } else {
+                    return fail(400);
+                }
+                break;
+
+            case State::TARGET:
+                if (c > 0x20 && c < 0x7f) {
+                    pos = Scanner::skipTargetChars(data, pos + 1, limit);
+                } else if (c == ' ' && pos > layout.target.offset) {
+                    layout.target.length = pos - layout.target.offset;
+                    layout.version.offset = ++pos;
+                    state = State::VERSION;
+                } else {
+                    return fail(400);
+                }
+                break;
+
+            case State::VERSION:
+                if (c == '\r') {
+                    layout.version.length = pos - layout.version.offset;
+                    if (!finishRequestLine(data)) {
+                        return status;
+                    }
+                    pos++;
+                    state = State::REQUEST_LINE_LF;
+                } else if (pos - layout.version.offset < 8) {
+                    pos++;
+                } else {
+                    return fail(400);
+                }
+                break;
+
+            case State::REQUEST_LINE_LF:
+            case State::HEADER_LF:
+                if (c != '\n') {
+                    return fail(400);
+                }
+                pos++;
+                state = State::HEADER_START;
+                break;
+
+            case State::HEADER_START:
+                if (c == '\r') {
+                    pos++;
+                    state = State::HEADERS_END_LF;
+                } else if (Scanner::isTokenChar(c)) {
+                    if (layout.headers.size() == maxHeaderCount) {
+                        return fail(431);
+                    }
+                    if (layout.headers.empty()) {
+                        layout.headers.reserve(EXPECTED_HEADERS);
+                    }
+                    layout.headers.emplace_back();
+                    layout.headers.back().name.offset = pos;
+                    state = State::HEADER_NAME;
+                } else {
+                    // Includes obsolete line folding, which is rejected outright
+                    return fail(400);
+                }
+                break;
+
+            case State::HEADER_NAME: {
+                Span& name = layout.headers.back().name;
+                if (Scanner::isTokenChar(c)) {
+                    pos = Scanner::skipTokenChars(data, pos + 1, limit);
+                } else if (c == ':') {
+                    name.length = pos - name.offset;
+                    pos++;
+                    state = State::HEADER_VALUE_START;
+                } else {
+                    // Whitespace between the name and the colon is not allowed
+                    return fail(400);
+                }
+                break;
+            }
+
+            case State::HEADER_VALUE_START:
+                if (c == ' ' || c == '\t') {
+                    pos++;
+                    break;
+                }
+                layout.headers.back().value.offset = pos;
+                state = State::HEADER_VALUE;
+                break;
+
+            case State::HEADER_VALUE: {
+                pos = Scanner::skipFieldChars(data, pos, limit);
+                if (pos == limit) {
+                    break;
+                }
+                if (data[pos] != '\r') {
+                    return fail(400);
+                }
+
+                // Trailing whitespace is not part of the value
+                HeaderField& field = layout.headers.back();
+                size_t valueEnd = pos;
+                while (valueEnd > field.value.offset && (data[valueEnd - 1] == ' ' || data[valueEnd - 1] == '\t')) {
+                    valueEnd--;
+                }
+                field.value.length = valueEnd - field.value.offset;
+                if (!finishHeader(data, field)) {
+                    return status;
+                }
+                pos++;
+                state = State::HEADER_LF;
+                break;
+            }
+
+            case State::HEADERS_END_LF:
+                if (c != '\n') {
+                    return fail(400);
+                }
+                layout.headerLength = ++pos;
+                if (!finishHeaders()) {
+                    return status;
+                }
+                chunkStart = pos;
+                state = chunked ? State::CHUNK_SIZE : State::BODY;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    if (chunked) {
+        return parseChunked(data, size);
+    }
+
+    if (size - layout.headerLength < layout.contentLength) {
+        return Status::INCOMPLETE;
+    }
+    if (layout.contentLength > 0) {
+        layout.bodyChunks.push_back({layout.headerLength, layout.contentLength});
+    }
+    messageLength = layout.headerLength + layout.contentLength;
+    status = Status::COMPLETE;
+    return status;
+}
+
+RequestParser::Status RequestParser::parseChunked(const char* data, size_t size) {
+    while (pos < size) {
+        unsigned char c = static_cast<unsigned char>(data[pos]);
+        switch (state) {
+            case State::CHUNK_SIZE:
+                if (isxdigit(c)) {
+                    // 15 hex digits is far beyond any body limit, and can't overflow
+                    if (++chunkDigits > 15) {
+                        return fail(413);
+                    }
+                    chunkSize = chunkSize * 16 + static_cast<size_t>(isdigit(c) ? c - '0' : (c | 0x20) - 'a' + 10);
+                    pos++;
+                } else if (chunkDigits == 0) {
+                    return fail(400);
+                } else if (c == ';' || c == ' ' || c == '\t') {
+                    pos++;
+                    state = State::CHUNK_EXTENSION;
+                } else if (c == '\r') {
+                    pos++;
+                    state = State::CHUNK_SIZE_LF;
+                } else {
+                    return fail(400);
+                }
+                break;
+
+            case State::CHUNK_EXTENSION:
+                // Extensions are skipped; they only have to be well-formed text
+                pos = Scanner::skipFieldChars(data, pos, size);
+                if (pos - chunkStart > MAX_CHUNK_HEADER) {
+                    return fail(400);
+                }
+                if (pos == size) {
+                    break;
+                }
+                if (data[pos] != '\r') {
+                    return fail(400);
+                }
+                pos++;
+                state = State::CHUNK_SIZE_LF;
+                break;
+
+            case State::CHUNK_SIZE_LF:
+                if (c != '\n') {
+                    return fail(400);
+                }
+                pos++;
+                // The limit covers the body as sent, framing included, and is
+                // checked against the declared size before the chunk data is
+                // buffered. Tiny chunks with long extensions would otherwise
+                // buffer far more than the decoded body.
+                if (pos - layout.headerLength > maxBodySize ||
+                    chunkSize > maxBodySize - (pos - layout.headerLength)) {
+                    return fail(413);
+                }
+                if (chunkSize == 0) {
+                    trailerStart = pos;
+                    state = State::TRAILER_START;
+                    break;
+                }
+                layout.bodyChunks.push_back({pos, chunkSize});
+                layout.contentLength += chunkSize;
+                chunkEnd = pos + chunkSize;
+                state = State::CHUNK_DATA;
+                break;
+
+            case State::CHUNK_DATA:
+                if (size - pos < chunkEnd - pos) {
+                    pos = size;
+                    break;
+                }
+                pos = chunkEnd;
+                state = State::CHUNK_DATA_CR;
+                break;
+
+            case State::CHUNK_DATA_CR:
+            case State::CHUNK_DATA_LF:
+                if (c != (state == State::CHUNK_DATA_CR ? '\r' : '\n')) {
+                    return fail(400);
+                }
+                pos++;
+                if (state == State::CHUNK_DATA_LF) {
+                    chunkSize = 0;
+                    chunkDigits = 0;
+                    chunkStart = pos;
+                    state = State::CHUNK_SIZE;
+                } else {
+                    state = State::CHUNK_DATA_LF;
+                }
+                break;
+
+            case State::TRAILER_START:
+                if (c == '\r') {
+                    pos++;
+                    state = State::TRAILERS_END_LF;
+                } else if (Scanner::isTokenChar(c)) {
+                    state = State::TRAILER_LINE;
+                } else {
+                    return fail(400);
+                }
+                break;
+
+            case State::TRAILER_LINE:
+                // Trailer fields are accepted but not exposed to handlers
+                pos = Scanner::skipFieldChars(data, pos, size);
+                if (pos == size) {
+                    break;
+                }
+                if (data[pos] != '\r') {
+                    return fail(400);
+                }
+                pos++;
+                state = State::TRAILER_LF;
+                break;
+
+            case State::TRAILER_LF:
+            case State::TRAILERS_END_LF:
+                if (c != '\n') {
+                    return fail(400);
+                }
+                pos++;
+                if (state == State::TRAILERS_END_LF) {
+                    messageLength = pos;
+                    status = Status::COMPLETE;
+                    return status;
+                }
+                state = State::TRAILER_START;
+                break;
+
+            default:
+                return fail(400);
+        }
+
+        if (trailerStart != 0 && pos - trailerStart > maxHeaderSize) {
+            return fail(431);
+        }
+    }
+    return Status::INCOMPLETE;
+}
+
+bool RequestParser::isAwaitingBody() const {
+    return status == Status::INCOMPLETE && state >= State::BODY;
+}
+
+bool RequestParser::finishRequestLine(const char* data) {
+    std::string_view version = layout.version.in(data);
+    if (version.size() != 8 || version.compare(0, 5, "HTTP/") != 0 ||
+        !isdigit(static_cast<unsigned char>(version[5])) || version[6] != '.' ||
+        !isdigit(static_cast<unsigned char>(version[7]))) {
+        fail(400);
+        return false;
+    }
+    if (version[5] != '1') {
+        fail(505);
+        return false;
+    }
+    isHttp11 = version[7] != '0';
+
+    std::string_view target = layout.target.in(data);
+    if (target[0] == '/' || target == "*") {
+        return true;
+    }
+
+    // Absolute form, as sent to proxies: routing only needs the path, so the
+    // span is narrowed past the scheme and authority
+    size_t schemeEnd = target.find("://");
+    if (schemeEnd == std::string_view::npos ||
+        (!equalsIgnoreCase(target.substr(0, schemeEnd), "http") &&
+         !equalsIgnoreCase(target.substr(0, schemeEnd), "https"))) {
+        fail(400);
+        return false;
+    }
+    size_t authorityStart = schemeEnd + 3;
+    size_t pathStart = target.find_first_of("/?", authorityStart);
+    if (pathStart == authorityStart) {
+        fail(400);
+        return false;
+    }
+    if (pathStart == std::string_view::npos) {
+        // No path means "/", and the "//" before the authority has one
+        layout.target.offset += schemeEnd + 1;
+        layout.target.length = 1;
+    } else if (target[pathStart] == '?') {
+        // "/" followed by the query isn't in the buffer to point at
+        fail(400);
+        return false;
+    } else {
+        layout.target.offset += pathStart;
+        layout.target.length -= pathStart;
+    }
+    return true;
+}
+
+bool RequestParser::finishHeader(const char* data, HeaderField& field) {
+    std::string_view value = field.value.in(data);
+    field.id = identifyHeader(field.name.in(data));
+    if (field.id == HeaderId::UNKNOWN) {
+        return true;
+    }
+
+    uint16_t& slot = layout.known[static_cast<size_t>(field.id)];
+    if (slot == 0 && layout.headers.size() <= UINT16_MAX) {
+        slot = static_cast<uint16_t>(layout.headers.size());
+    }
+
+    if (field.id == HeaderId::CONTENT_LENGTH) {
+        if (value.empty() || value.size() > 18) {
+            fail(400);
+            return false;
+        }
+        size_t length = 0;
+        for (char c : value) {
+            if (!isdigit(static_cast<unsigned char>(c))) {
+                fail(400);
+                return false;
+            }
+            length = length * 10 + static_cast<size_t>(c - '0');
+        }
+        // Repeated Content-Length headers must agree, or framing is ambiguous
+        if (hasContentLength && length != layout.contentLength) {
+            fail(400);
+            return false;
+        }
+        hasContentLength = true;
+        layout.contentLength = length;
+    } else if (field.id == HeaderId::TRANSFER_ENCODING) {
+        // chunked is the only coding understood, and it has to come last
+        if (!equalsIgnoreCase(value, "chunked")) {
+            fail(501);
+            return false;
+        }
+        chunked = true;
+    } else if (field.id == HeaderId::EXPECT) {
+        if (!equalsIgnoreCase(value, "100-continue")) {
+            fail(417);
+            return false;
+        }
+        // HTTP/1.0 clients don't know about 100 Continue
+        expectContinue = isHttp11;
+    } else if (field.id == HeaderId::HOST) {
+        hostCount++;
+    } else if (field.id == HeaderId::CONNECTION) {
+        parseConnection(value, layout);
+    }
+    return true;
+}
+
+bool RequestParser::finishHeaders() {
+    // HTTP/1.1 requests carry exactly one Host header
+    if (hostCount > 1 || (hostCount == 0 && isHttp11)) {
+        fail(400);
+        return false;
+    }
+
+    // A message with both is a request smuggling attempt
+    if (chunked && hasContentLength) {
+        fail(400);
+        return false;
+    }
+
+    // Refuse oversized bodies before any of the body is read
+    if (layout.contentLength > maxBodySize) {
+        fail(413);
+        return false;
+    }
+    return true;
+}
+
+bool RequestParser::equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (tolower(static_cast<unsigned char>(a[i])) != tolower(static_cast<unsigned char>(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+HeaderId RequestParser::identifyHeader(std::string_view name) {
+    if (name.empty()) {
+        return HeaderId::UNKNOWN;
+    }
+    char first = static_cast<char>(tolower(static_cast<unsigned char>(name[0])));
+    for (size_t i = 0; i < static_cast<size_t>(HeaderId::UNKNOWN); ++i) {
+        std::string_view known = HEADER_NAMES[i];
+        if (known.size() == name.size() && tolower(static_cast<unsigned char>(known[0])) == first &&
+            equalsIgnoreCase(known, name)) {
+            return static_cast<HeaderId>(i);
+        }
+    }
+    return HeaderId::UNKNOWN;
+}
@@ -0,0 +1,160 @@
+// src/http/RequestParser.h
+#pragma once
+#include <string_view>
+#include <vector>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Location of a token inside the raw request, relative to its first byte.
+// Offsets rather than pointers so a layout survives the buffer growing.
+struct Span {
+    size_t offset = 0;
+    size_t length = 0;
+
+    std::string_view in(const char* base) const { return std::string_view(base + offset, length); }
+};
+
+// Headers the server looks at itself. They are identified once while
+// parsing, so finding one later is a table lookup rather than a scan.
+enum class HeaderId : uint8_t {
+    HOST,
+    CONNECTION,
+    CONTENT_LENGTH,
+    CONTENT_TYPE,
+    TRANSFER_ENCODING,
+    EXPECT,
+    ACCEPT,
+    ACCEPT_ENCODING,
+    RANGE,
+    IF_RANGE,
+    IF_NONE_MATCH,
+    IF_MODIFIED_SINCE,
+    USER_AGENT,
+    REFERER,
+    ORIGIN,
+    COOKIE,
+    AUTHORIZATION,
+    UNKNOWN     // Also the number of known headers
+};
+
+struct HeaderField {
+    Span name;
+    Span value;
+    HeaderId id = HeaderId::UNKNOWN;
+};
+
+struct RequestLayout {
+    Span method;
+    Span target;
+    Span version;
+    std::vector<HeaderField> headers;
+
+    // Index + 1 into headers of the first header with each known id, 0 if
+    // the request doesn't have it
+    std::array<uint16_t, static_cast<size_t>(HeaderId::UNKNOWN)> known{};
+
+    // Tokens of the Connection header, parsed once
+    bool connectionClose = false;
+    bool connectionKeepAlive = false;
+
+    size_t headerLength = 0;    // Request line and headers, including the blank line
+    size_t contentLength = 0;   // Decoded body size, also for chunked bodies
+
+    // Where the body bytes are: one span for a Content-Length body, one per
+    // chunk of a chunked body
+    std::vector<Span> bodyChunks;
+};
+
+// Incremental HTTP/1.x request parser. Each call to parse() is handed the
+// bytes received so far for the current request and continues from where
+// the previous call stopped, so a request split across many reads is only
+// scanned once. Nothing is copied: the result is a set of spans into the
+// caller's buffer.
+class RequestParser {
+public:
+    enum class Status {
+        INCOMPLETE,
+        COMPLETE,
+        ERROR
+    };
+
+    RequestParser() = default;
+
+    // maxBodySize bounds the body as sent; for a chunked body that includes
+    // its chunk framing
+    void setLimits(size_t maxHeaderSize, size_t maxHeaderCount, size_t maxBodySize);
+
+    Status parse(const char* data, size_t size);
+    void reset();
+
+    RequestLayout& getLayout() { return layout; }
+    size_t getMessageLength() const { return messageLength; }
+
+    // Headers are complete and the body is still arriving
+    bool isAwaitingBody() const;
+    bool expectsContinue() const { return expectContinue; }
+
+    // Status code to answer a malformed request with
+    int getErrorStatus() const { return errorStatus; }
+
+    static bool equalsIgnoreCase(std::string_view a, std::string_view b);
+    static HeaderId identifyHeader(std::string_view name);
+
+private:
+    enum class State {
+        START,
+        METHOD,
+        TARGET,
+        VERSION,
+        REQUEST_LINE_LF,
+        HEADER_START,
+        HEADER_NAME,
+        HEADER_VALUE_START,
+        HEADER_VALUE,
+        HEADER_LF,
+        HEADERS_END_LF,
+        BODY,
+        CHUNK_SIZE,
+        CHUNK_EXTENSION,
+        CHUNK_SIZE_LF,
+        CHUNK_DATA,
+        CHUNK_DATA_CR,
+        CHUNK_DATA_LF,
+        TRAILER_START,
+        TRAILER_LINE,
+        TRAILER_LF,
+        TRAILERS_END_LF
+    };
+
+    static constexpr size_t MAX_CHUNK_HEADER = 1024;
+
+    Status fail(int status);
+    Status parseChunked(const char* data, size_t size);
+    bool finishRequestLine(const char* data);
+    bool finishHeader(const char* data, HeaderField& field);
+    bool finishHeaders();
+
+    RequestLayout layout;
+    State state = State::START;
+    Status status = Status::INCOMPLETE;
+    size_t pos = 0;
+    size_t messageLength = 0;
+    int errorStatus = 0;
+
+    size_t hostCount = 0;
+    bool hasContentLength = false;
+    bool isHttp11 = false;
+    bool chunked = false;
+    bool expectContinue = false;
+
+    size_t chunkSize = 0;
+    size_t chunkDigits = 0;
+    size_t chunkStart = 0;      // Start of the current chunk-size line
+    size_t chunkEnd = 0;
+    size_t trailerStart = 0;
+
+    size_t maxHeaderSize = 8192;
+    size_t maxHeaderCount = 100;
+    size_t maxBodySize = 10485760;
+};
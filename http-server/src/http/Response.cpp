@@ -1,162 +1,363 @@
-// src/http/Response.cpp
-#include "Response.h"
-#include <sstream>
-#include <map>
-
-HttpResponse& HttpResponse::setStatusCode(int code) {
-    statusCode = code;
-    statusMessage = getStatusMessage(code);
-    return *this;
-}
-
-HttpResponse& HttpResponse::setStatusMessage(const std::string& message) {
-    statusMessage = message;
-    return *this;
-}
-
-HttpResponse& HttpResponse::setHeader(const std::string& key, const std::string& value) {
-    headers[key] = value;
-    return *this;
-}
-
-HttpResponse& HttpResponse::setBody(const std::string& bodyContent) {
-    body = bodyContent;
-    setHeader("Content-Length", std::to_string(body.length()));
-    return *this;
-}
-
-HttpResponse& HttpResponse::setContentType(const std::string& type) {
-    setHeader("Content-Type", type);
-    return *this;
-}
-
-void HttpResponse::setDefaultHeaders() {
-    headers["Server"] = "C++ HTTP Server";
-    headers["Date"] = getCurrentTime();
-    headers["Connection"] = "close";
-}
-
-std::string HttpResponse::toString() const {
-    std::ostringstream response;
-    
-    // Status line
-    response << "HTTP/1.1 " << statusCode << " " << statusMessage << "\r\n";
-    
-    // Headers
-    for (const auto& header : headers) {
-        response << header.first << ": " << header.second << "\r\n";
-    }
-    
-    // Empty line separating headers and body
-    response << "\r\n";
-    
-    // Body
-    if (!body.empty()) {
-        response << body;
-    }
-    
-    return response.str();
-}
-
-HttpResponse HttpResponse::makeErrorResponse(int code, const std::string& message) {
-    HttpResponse response;
-    response.setStatusCode(code);
-    
-    std::string html = "<!DOCTYPE html>\n";
-    html += "<html><head><title>" + std::to_string(code) + " " + message + "</title></head>\n";
-    html += "<body>\n";
-    html += "<h1>" + std::to_string(code) + " " + message + "</h1>\n";
-    html += "<hr>\n";
-    html += "<p>C++ HTTP Server</p>\n";
-    html += "</body></html>";
-    
-    response.setContentType("text/html");
-    response.setBody(html);
-    
-    return response;
-}
-
-HttpResponse HttpResponse::makeFileResponse(const std::string& fileContent, const std::string& contentType) {
-    HttpResponse response;
-    response.setStatusCode(200);
-    response.setContentType(contentType);
-    response.setBody(fileContent);
-    return response;
-}
-
-HttpResponse HttpResponse::makeTextResponse(const std::string& text) {
-    HttpResponse response;
-    response.setStatusCode(200);
-    response.setContentType("text/plain");
-    response.setBody(text);
-    return response;
-}
-
-HttpResponse HttpResponse::makeRedirectResponse(const std::string& location) {
-    HttpResponse response;
-    response.setStatusCode(302);
-    response.setHeader("Location", location);
-    response.setContentType("text/html");
-    response.setBody("<html><body>Redirecting to <a href=\"" + location + "\">" + location + "</a></body></html>");
-    return response;
-}
-
-std::string HttpResponse::getStatusMessage(int code) {
-    static const std::map<int, std::string> statusMessages = {
-        {200, "OK"},
-        {201, "Created"},
-        {204, "No Content"},
-        {301, "Moved Permanently"},
-        {302, "Found"},
-        {304, "Not Modified"},
-        {400, "Bad Request"},
-        {401, "Unauthorized"},
-        {403, "Forbidden"},
-        {404, "Not Found"},
-        {405, "Method Not Allowed"},
-        {500, "Internal Server Error"},
-        {501, "Not Implemented"},
-        {503, "Service Unavailable"}
-    };
-    
-    auto it = statusMessages.find(code);
-    if (it != statusMessages.end()) {
-        return it->second;
-    }
-    return "Unknown Status";
-}
-
-std::string HttpResponse::getMimeType(const std::string& extension) {
-    static const std::map<std::string, std::string> mimeTypes = {
-        {".html", "text/html"},
-        {".htm", "text/html"},
-        {".css", "text/css"},
-        {".js", "application/javascript"},
-        {".json", "application/json"},
-        {".png", "image/png"},
-        {".jpg", "image/jpeg"},
-        {".jpeg", "image/jpeg"},
-        {".gif", "image/gif"},
-        {".svg", "image/svg+xml"},
-        {".txt", "text/plain"},
-        {".pdf", "application/pdf"},
-        {".zip", "application/zip"},
-        {".xml", "application/xml"}
-    };
-    
-    auto it = mimeTypes.find(extension);
-    if (it != mimeTypes.end()) {
-        return it->second;
-    }
-    return "application/octet-stream";
-}
-
-std::string HttpResponse::getCurrentTime() {
-    time_t now = time(nullptr);
-    struct tm* timeinfo = gmtime(&now);
-    
-    char buffer[80];
-    strftime(buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", timeinfo);
-    
-    return std::string(buffer);
+// src/http/Response.cpp
+#include "Response.h"
+#include "MimeTypes.h"
+#include <map>
+#include <strings.h>
+
+namespace {
+
+bool sameHeaderName(std::string_view a, std::string_view b) {
+    return a.size() == b.size() && strncasecmp(a.data(), b.data(), a.size()) == 0;
+}
+
+// Headers that are the same on every response, serialized once
+const std::string SERVER_LINE = "Server: C++ HTTP Server\r\n";
+const std::string CORS_ORIGIN_LINES = "Access-Control-Allow-Origin: *\r\n";
+const std::string CORS_FULL_LINES = "Access-Control-Allow-Origin: *\r\n"
+                                    "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
+                                    "Access-Control-Allow-Headers: Content-Type\r\n";
+
+}
+
+HttpResponse& HttpResponse::setStatusCode(int code) {
+    statusCode = code;
+    statusMessage.assign(getStatusMessage(code));
+    return *this;
+}
+
+HttpResponse& HttpResponse::setStatusMessage(const std::string& message) {
+    statusMessage = message;
+    return *this;
+}
+
+HttpResponse& HttpResponse::setHeader(std::string_view key, std::string_view value) {
+    for (auto& header : headers) {
+        if (sameHeaderName(header.first, key)) {
+            header.second = value;
+            return *this;
+        }
+    }
+    headers.emplace_back(key, value);
+    return *this;
+}
+
+BodySegment BodySegment::fromString(std::string bytes) {
+    BodySegment segment;
+    segment.length = bytes.size();
+    segment.data = std::move(bytes);
+    return segment;
+}
+
+BodySegment BodySegment::fromShared(std::shared_ptr<const std::string> content, size_t offset, size_t length) {
+    BodySegment segment;
+    segment.shared = std::move(content);
+    segment.offset = offset;
+    segment.length = length;
+    return segment;
+}
+
+BodySegment BodySegment::fromFile(std::shared_ptr<FileHandle> file, size_t offset, size_t length) {
+    BodySegment segment;
+    segment.file = std::move(file);
+    segment.offset = offset;
+    segment.length = length;
+    return segment;
+}
+
+BodySegment BodySegment::slice(size_t start, size_t count) const {
+    if (!shared && !file) {
+        return fromString(data.substr(start, count));
+    }
+    BodySegment segment = *this;
+    segment.offset = offset + start;
+    segment.length = count;
+    return segment;
+}
+
+HttpResponse& HttpResponse::setBody(std::string bodyContent) {
+    body = std::move(bodyContent);
+    bodySegments.clear();
+    setHeader("Content-Length", std::to_string(body.length()));
+    return *this;
+}
+
+HttpResponse& HttpResponse::setFileBody(std::shared_ptr<FileHandle> file, size_t offset, size_t length) {
+    BodySegments segments(RequestArena::current());
+    segments.push_back(BodySegment::fromFile(std::move(file), offset, length));
+    return setBodySegments(std::move(segments));
+}
+
+HttpResponse& HttpResponse::setSharedBody(std::shared_ptr<const std::string> content) {
+    BodySegments segments(RequestArena::current());
+    size_t length = content ? content->size() : 0;
+    segments.push_back(BodySegment::fromShared(std::move(content), 0, length));
+    return setBodySegments(std::move(segments));
+}
+
+HttpResponse& HttpResponse::setBodySegments(BodySegments segments) {
+    body.clear();
+    bodySegments = std::move(segments);
+    
+    size_t length = 0;
+    for (const auto& segment : bodySegments) {
+        length += segment.length;
+    }
+    setHeader("Content-Length", std::to_string(length));
+    return *this;
+}
+
+HttpResponse& HttpResponse::removeHeader(std::string_view key) {
+    for (auto it = headers.begin(); it != headers.end(); ++it) {
+        if (sameHeaderName(it->first, key)) {
+            headers.erase(it);
+            break;
+        }
+    }
+    return *this;
+}
+
+HttpResponse& HttpResponse::setBodyProducer(BodyProducer producer) {
+    body.clear();
+    bodySegments.clear();
+    removeHeader("Content-Length");
+    bodyProducer = std::move(producer);
+    return *this;
+}
+
+BodyProducer HttpResponse::takeBodyProducer() {
+    BodyProducer producer = std::move(bodyProducer);
+    bodyProducer = nullptr;
+    return producer;
+}
+
+HttpResponse& HttpResponse::stripBody() {
+    body.clear();
+    bodySegments.clear();
+    if (bodyProducer) {
+        bodyProducer = nullptr;
+        streamStripped = true;
+    }
+    return *this;
+}
+
+HttpResponse& HttpResponse::setNotModified() {
+    setStatusCode(304);
+    stripBody();
+    streamStripped = false;
+    removeHeader("Content-Length");
+    removeHeader("Content-Type");
+    removeHeader("Content-Encoding");
+    return *this;
+}
+
+std::string_view HttpResponse::getHeader(std::string_view key) const {
+    for (const auto& header : headers) {
+        if (sameHeaderName(header.first, key)) {
+            return header.second;
+        }
+    }
+    return std::string_view();
+}
+
+std::string HttpResponse::takeBody() {
+    return std::move(body);
+}
+
+size_t HttpResponse::getBodyLength() const {
+    size_t length = body.size();
+    for (const auto& segment : bodySegments) {
+        length += segment.length;
+    }
+    return length;
+}
+
+HttpResponse& HttpResponse::setContentType(std::string_view type) {
+    setHeader("Content-Type", type);
+    return *this;
+}
+
+HttpResponse& HttpResponse::setCorsPolicy(CorsPolicy policy) {
+    corsPolicy = policy;
+    return *this;
+}
+
+void HttpResponse::serializeHead(std::string& out) const {
+    // Status line, pre-built for the standard reason phrases
+    const std::string* statusLine = getStatusLine(statusCode);
+    if (statusLine != nullptr && statusMessage == getStatusMessage(statusCode)) {
+        out += *statusLine;
+    } else {
+        out += "HTTP/1.1 ";
+        out += std::to_string(statusCode);
+        out += ' ';
+        out += statusMessage;
+        out += "\r\n";
+    }
+    
+    // Constant headers first, spliced in from their cached lines
+    out += SERVER_LINE;
+    out += getDateLine();
+    if (corsPolicy == CorsPolicy::ALLOW_ORIGIN) {
+        out += CORS_ORIGIN_LINES;
+    } else if (corsPolicy == CorsPolicy::FULL) {
+        out += CORS_FULL_LINES;
+    }
+    
+    // Headers
+    bool hasContentLength = false;
+    bool hasTransferEncoding = false;
+    for (const auto& header : headers) {
+        out += header.first;
+        out += ": ";
+        out += header.second;
+        out += "\r\n";
+        hasContentLength = hasContentLength || sameHeaderName(header.first, "Content-Length");
+        hasTransferEncoding = hasTransferEncoding || sameHeaderName(header.first, "Transfer-Encoding");
+    }
+    
+    // Persistent connections need every response to be framed; 304 and
+    // 204 never carry a body. Streamed bodies are framed by chunked encoding
+    // or by closing the connection, as is HEAD for one.
+    bool bodiless = statusCode == 304 || statusCode == 204;
+    bool streamed = bodyProducer || streamStripped || hasTransferEncoding;
+    if (!bodiless && !streamed && !hasContentLength) {
+        out += "Content-Length: ";
+        out += std::to_string(body.length());
+        out += "\r\n";
+    }
+    
+    // Empty line separating headers and body
+    out += "\r\n";
+}
+
+std::string HttpResponse::toString() const {
+    std::string response;
+    response.reserve(256 + body.size());
+    serializeHead(response);
+    response += body;
+    return response;
+}
+
+HttpResponse HttpResponse::makeErrorResponse(int code, const std::string& message) {
+    HttpResponse response;
+    response.setStatusCode(code);
+    
+    std::string html = "<!DOCTYPE html>\n";
+    html += "<html><head><title>" + std::to_string(code) + " " + message + "</title></head>\n";
+    html += "<body>\n";
+    html += "<h1>" + std::to_string(code) + " " + message + "</h1>\n";
+    html += "<hr>\n";
+    html += "<p>C++ HTTP Server</p>\n";
+    html += "</body></html>";
+    
+    response.setContentType("text/html");
+    response.setBody(html);
+    
+    return response;
+}
+
+HttpResponse HttpResponse::makeFileResponse(const std::string& fileContent, const std::string& contentType) {
+    HttpResponse response;
+    response.setStatusCode(200);
+    response.setContentType(contentType);
+    response.setBody(fileContent);
+    return response;
+}
+
+HttpResponse HttpResponse::makeTextResponse(const std::string& text) {
+    HttpResponse response;
+    response.setStatusCode(200);
+    response.setContentType("text/plain");
+    response.setBody(text);
+    return response;
+}
+
+HttpResponse HttpResponse::makeRedirectResponse(const std::string& location) {
+    HttpResponse response;
+    response.setStatusCode(302);
+    response.setHeader("Location", location);
+    response.setContentType("text/html");
+    response.setBody("<html><body>Redirecting to <a href=\"" + location + "\">" + location + "</a></body></html>");
+    return response;
+}
+
+std::string_view HttpResponse::getStatusMessage(int code) {
+    static const std::map<int, std::string_view> statusMessages = {
+        {200, "OK"},
+        {201, "Created"},
+        {204, "No Content"},
+        {206, "Partial Content"},
+        {301, "Moved Permanently"},
+        {302, "Found"},
+        {304, "Not Modified"},
+        {400, "Bad Request"},
+        {401, "Unauthorized"},
+        {403, "Forbidden"},
+        {404, "Not Found"},
+        {405, "Method Not Allowed"},
+        {413, "Payload Too Large"},
+        {414, "URI Too Long"},
+        {416, "Range Not Satisfiable"},
+        {417, "Expectation Failed"},
+        {431, "Request Header Fields Too Large"},
+        {500, "Internal Server Error"},
+        {501, "Not Implemented"},
+        {503, "Service Unavailable"},
+        {505, "HTTP Version Not Supported"}
+    };
+    
+    auto it = statusMessages.find(code);
+    if (it != statusMessages.end()) {
+        return it->second;
+    }
+    return "Unknown Status";
+}
+
+const std::string* HttpResponse::getStatusLine(int code) {
+    static const std::map<int, std::string> statusLines = [] {
+        std::map<int, std::string> lines;
+        for (int code : {200, 201, 204, 206, 301, 302, 304, 400, 401, 403, 404, 405, 413, 414, 416, 417,
+                         431, 500, 501, 503, 505}) {
+            lines[code] = "HTTP/1.1 " + std::to_string(code) + " " + std::string(getStatusMessage(code)) + "\r\n";
+        }
+        return lines;
+    }();
+    
+    auto it = statusLines.find(code);
+    return it != statusLines.end() ? &it->second : nullptr;
+}
+
+std::string HttpResponse::getMimeType(const std::string& extension) {
+    std::string_view type = MimeTypes::find(extension);
+    return std::string(type.empty() ? MimeTypes::DEFAULT_TYPE : type);
+}
+
+const std::string& HttpResponse::getDateLine() {
+    // Date only changes once a second, so each thread keeps the formatted
+    // line and rebuilds it when the second rolls over
+    thread_local time_t cachedSecond = -1;
+    thread_local std::string cachedLine;
+    
+    time_t now = time(nullptr);
+    if (now != cachedSecond) {
+        cachedSecond = now;
+        cachedLine = "Date: " + formatHttpDate(now) + "\r\n";
+    }
+    return cachedLine;
+}
+
+std::string HttpResponse::formatHttpDate(time_t time) {
+    struct tm timeinfo;
+    gmtime_r(&time, &timeinfo);
+    
+    char buffer[80];
+    strftime(buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", &timeinfo);
+    
+    return std::string(buffer);
+}
+
+std::string_view HttpResponse::formatHttpDate(time_t time, char (&buffer)[HTTP_DATE_SIZE]) {
+    struct tm timeinfo;
+    gmtime_r(&time, &timeinfo);
+    return std::string_view(buffer, strftime(buffer, HTTP_DATE_SIZE, "%a, %d %b %Y %H:%M:%S GMT", &timeinfo));
 }
\ No newline at end of file
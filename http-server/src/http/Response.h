@@ -1,41 +1,130 @@
-// src/http/Response.h
-#pragma once
-#include <string>
-#include <unordered_map>
-#include <ctime>
-
-class HttpResponse {
-private:
-    int statusCode;
-    std::string statusMessage;
-    std::unordered_map<std::string, std::string> headers;
-    std::string body;
-    
-    static std::string getStatusMessage(int code);
-    
-public:
-    HttpResponse() : statusCode(200) {
-        setDefaultHeaders();
-    }
-    
-    // Builder pattern methods
-    HttpResponse& setStatusCode(int code);
-    HttpResponse& setStatusMessage(const std::string& message);
-    HttpResponse& setHeader(const std::string& key, const std::string& value);
-    HttpResponse& setBody(const std::string& bodyContent);
-    HttpResponse& setContentType(const std::string& type);
-    
-    // Generate response string
-    std::string toString() const;
-    
-    // Common responses
-    static HttpResponse makeErrorResponse(int code, const std::string& message);
-    static HttpResponse makeFileResponse(const std::string& fileContent, const std::string& contentType);
-    static HttpResponse makeTextResponse(const std::string& text);
-    static HttpResponse makeRedirectResponse(const std::string& location);
-    
-private:
-    void setDefaultHeaders();
-    static std::string getMimeType(const std::string& extension);
-    static std::string getCurrentTime();
+// src/http/Response.h
+#pragma once
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <memory_resource>
+#include <functional>
+#include <ctime>
+#include "../utils/Arena.h"
+
+class FileHandle;
+
+// A piece of a response body transmitted by reference rather than through
+// the serialized string: literal bytes, a slice of bytes shared with the
+// file cache, or a region of an open file sent with sendfile.
+struct BodySegment {
+    std::string data;
+    std::shared_ptr<const std::string> shared;
+    std::shared_ptr<FileHandle> file;
+    size_t offset = 0;
+    size_t length = 0;
+    
+    static BodySegment fromString(std::string bytes);
+    static BodySegment fromShared(std::shared_ptr<const std::string> content, size_t offset, size_t length);
+    static BodySegment fromFile(std::shared_ptr<FileHandle> file, size_t offset, size_t length);
+    
+    // Same source, narrowed to [start, start + count) of this segment
+    BodySegment slice(size_t start, size_t count) const;
+};
+
+// Segment lists are built per request, so they come from the request arena
+using BodySegments = std::pmr::vector<BodySegment>;
+
+// Which Access-Control-* headers a response carries. They are constant, so
+// they are written from pre-serialized blocks rather than stored per response.
+enum class CorsPolicy {
+    NONE,
+    ALLOW_ORIGIN,   // Access-Control-Allow-Origin: *
+    FULL            // Plus the allowed methods and headers
+};
+
+// Generates a body piece by piece for responses that are streamed rather
+// than built up front. Each call appends the next piece to chunk and
+// returns false once the body is complete.
+using BodyProducer = std::function<bool(std::string& chunk)>;
+
+class HttpResponse {
+private:
+    int statusCode;
+    std::string statusMessage;
+    // In insertion order; names compare case-insensitively. Allocated from
+    // the request arena when the response is built inside an ArenaScope.
+    std::pmr::vector<std::pair<std::pmr::string, std::pmr::string>> headers;
+    std::string body;
+    
+    // Body sent by reference after the headers, used instead of body
+    BodySegments bodySegments;
+    
+    // Set for streamed responses, which have no Content-Length
+    BodyProducer bodyProducer;
+    bool streamStripped;    // stripBody dropped a producer; framing is left to the caller
+    
+    CorsPolicy corsPolicy;
+    
+    // Enough for a static file response with validators and keep-alive
+    static constexpr size_t EXPECTED_HEADERS = 12;
+    
+public:
+    HttpResponse()
+        : statusCode(200), headers(RequestArena::current()), bodySegments(RequestArena::current()),
+          streamStripped(false), corsPolicy(CorsPolicy::NONE) {
+        headers.reserve(EXPECTED_HEADERS);
+    }
+    
+    // Builder pattern methods
+    HttpResponse& setStatusCode(int code);
+    HttpResponse& setStatusMessage(const std::string& message);
+    HttpResponse& setHeader(std::string_view key, std::string_view value);
+    HttpResponse& setBody(std::string bodyContent);
+    HttpResponse& setContentType(std::string_view type);
+    HttpResponse& setFileBody(std::shared_ptr<FileHandle> file, size_t offset, size_t length);
+    HttpResponse& setSharedBody(std::shared_ptr<const std::string> content);
+    HttpResponse& setBodySegments(BodySegments segments);
+    HttpResponse& setBodyProducer(BodyProducer producer);
+    HttpResponse& removeHeader(std::string_view key);
+    HttpResponse& setCorsPolicy(CorsPolicy policy);
+    
+    // Drops the body but keeps Content-Length, as a HEAD response must
+    HttpResponse& stripBody();
+    
+    // Turns a 200 into a bodiless 304, keeping the validator headers
+    HttpResponse& setNotModified();
+    
+    // Appends the status line and headers, through the blank line. The body
+    // is left to the caller so it can be written by reference.
+    void serializeHead(std::string& out) const;
+    
+    // Head plus string body in one buffer. Body segments are not included;
+    // the caller transmits them separately.
+    std::string toString() const;
+    
+    int getStatusCode() const { return statusCode; }
+    std::string_view getHeader(std::string_view key) const;    // Valid while the header is unchanged
+    
+    const BodySegments& getBodySegments() const { return bodySegments; }
+    std::string takeBody();
+    size_t getBodyLength() const;       // Bytes of body to be sent, not counting a producer
+    bool isStreaming() const { return bodyProducer != nullptr; }
+    bool wasStreaming() const { return streamStripped; }    // A HEAD response GET would have streamed
+    BodyProducer takeBodyProducer();
+    
+    // Common responses
+    static HttpResponse makeErrorResponse(int code, const std::string& message);
+    static std::string_view getStatusMessage(int code);    // Static storage
+    static HttpResponse makeFileResponse(const std::string& fileContent, const std::string& contentType);
+    static HttpResponse makeTextResponse(const std::string& text);
+    static HttpResponse makeRedirectResponse(const std::string& location);
+    
+    // RFC 7231 IMF-fixdate, e.g. "Sun, 06 Nov 1994 08:49:37 GMT"
+    static std::string formatHttpDate(time_t time);
+    static constexpr size_t HTTP_DATE_SIZE = 30;       // Including the terminator
+    static std::string_view formatHttpDate(time_t time, char (&buffer)[HTTP_DATE_SIZE]);
+    
+private:
+    static std::string getMimeType(const std::string& extension);
+    static const std::string* getStatusLine(int code);
+    static const std::string& getDateLine();
 };
\ No newline at end of file
@@ -0,0 +1,216 @@
+// src/http/Router.cpp
+#include "Router.h"
+#include <stdexcept>
+
+std::string_view RouteParams::get(std::string_view name) const {
+    for (size_t i = 0; i < count; ++i) {
+        if (items[i].first == name) {
+            return items[i].second;
+        }
+    }
+    return {};
+}
+
+Router::Node* Router::Node::findChild(char c) const {
+    size_t index = childIndex.find(c);
+    return index == std::string::npos ? nullptr : children[index].get();
+}
+
+uint32_t Router::Node::allowedMethods() const {
+    uint32_t allowed = 0;
+    for (size_t i = 0; i < METHOD_COUNT; ++i) {
+        if (handlers[i] >= 0) {
+            allowed |= 1u << i;
+        }
+    }
+    // HEAD is answered by GET
+    if (allowed & (1u << static_cast<size_t>(HttpMethod::GET))) {
+        allowed |= 1u << static_cast<size_t>(HttpMethod::HEAD);
+    }
+    return allowed;
+}
+
+Router::Router() : root(new Node()), frozen(false) {}
+
+Router::~Router() = default;
+
+const Router::Route& Router::add(HttpMethod method, const std::string& pattern, RouteHandler handler, size_t tag) {
+    if (frozen) {
+        throw std::logic_error("route added after the router was frozen: " + pattern);
+    }
+    if (method == HttpMethod::UNKNOWN) {
+        throw std::logic_error("route needs a known method: " + pattern);
+    }
+    if (pattern.empty() || pattern[0] != '/') {
+        throw std::logic_error("route pattern must start with '/': " + pattern);
+    }
+
+    Node* node = root.get();
+    size_t params = 0;
+    size_t i = 0;
+    while (i < pattern.size()) {
+        char c = pattern[i];
+        if (c == ':' || c == '*') {
+            if (pattern[i - 1] != '/') {
+                throw std::logic_error("parameter must start a path segment: " + pattern);
+            }
+            if (++params > RouteParams::MAX_PARAMS) {
+                throw std::logic_error("too many parameters in route: " + pattern);
+            }
+
+            size_t end = c == ':' ? pattern.find('/', i) : pattern.size();
+            if (end == std::string::npos) {
+                end = pattern.size();
+            }
+            std::string name = pattern.substr(i + 1, end - i - 1);
+            if (name.empty() || name.find_first_of(":*") != std::string::npos) {
+                throw std::logic_error("bad parameter name in route: " + pattern);
+            }
+            if (c == '*' && pattern.find('/', i) != std::string::npos) {
+                throw std::logic_error("wildcard must be the last segment: " + pattern);
+            }
+
+            std::unique_ptr<Node>& child = c == ':' ? node->param : node->wildcard;
+            std::string& childName = c == ':' ? node->paramName : node->wildcardName;
+            if (!child) {
+                child.reset(new Node());
+                childName = name;
+            } else if (childName != name) {
+                throw std::logic_error("route " + pattern + " renames parameter '" + childName + "'");
+            }
+            node = child.get();
+            i = end;
+            continue;
+        }
+
+        size_t end = pattern.find_first_of(":*", i);
+        if (end == std::string::npos) {
+            end = pattern.size();
+        }
+        node = insertLiteral(node, std::string_view(pattern).substr(i, end - i));
+        i = end;
+    }
+
+    size_t methodIndex = static_cast<size_t>(method);
+    if (node->handlers[methodIndex] >= 0) {
+        throw std::logic_error(std::string("duplicate route: ") + HttpRequest::methodToString(method) + " " + pattern);
+    }
+    node->handlers[methodIndex] = static_cast<int32_t>(routes.size());
+    routes.push_back(std::unique_ptr<Route>(new Route{pattern, std::move(handler), tag}));
+    return *routes.back();
+}
+
+Router::Node* Router::insertLiteral(Node* node, std::string_view text) {
+    while (!text.empty()) {
+        Node* child = node->findChild(text[0]);
+        if (!child) {
+            std::unique_ptr<Node> leaf(new Node());
+            leaf->prefix = std::string(text);
+            node->childIndex += text[0];
+            node->children.push_back(std::move(leaf));
+            return node->children.back().get();
+        }
+
+        size_t common = 0;
+        size_t limit = std::min(child->prefix.size(), text.size());
+        while (common < limit && child->prefix[common] == text[common]) {
+            ++common;
+        }
+        if (common < child->prefix.size()) {
+            split(child, common);
+        }
+        node = child;
+        text.remove_prefix(common);
+    }
+    return node;
+}
+
+void Router::split(Node* node, size_t length) {
+    // The tail of the label moves to a new child that takes over everything
+    // hanging off the node
+    std::unique_ptr<Node> tail(new Node());
+    tail->prefix = node->prefix.substr(length);
+    tail->children = std::move(node->children);
+    tail->childIndex = std::move(node->childIndex);
+    tail->param = std::move(node->param);
+    tail->paramName = std::move(node->paramName);
+    tail->wildcard = std::move(node->wildcard);
+    tail->wildcardName = std::move(node->wildcardName);
+    tail->handlers = node->handlers;
+
+    node->prefix.resize(length);
+    node->children.clear();
+    node->childIndex.assign(1, tail->prefix[0]);
+    node->paramName.clear();
+    node->wildcardName.clear();
+    node->handlers.fill(-1);
+    node->children.push_back(std::move(tail));
+}
+
+int32_t Router::handlerFor(const Node* node, size_t methodIndex) const {
+    int32_t handler = node->handlers[methodIndex];
+    if (handler < 0 && methodIndex == static_cast<size_t>(HttpMethod::HEAD)) {
+        handler = node->handlers[static_cast<size_t>(HttpMethod::GET)];
+    }
+    return handler;
+}
+
+bool Router::matchNode(const Node* node, std::string_view path, size_t methodIndex, Match& match) const {
+    if (path.empty()) {
+        int32_t handler = handlerFor(node, methodIndex);
+        if (handler >= 0) {
+            match.route = routes[handler].get();
+            return true;
+        }
+        match.allowed |= node->allowedMethods();
+    } else {
+        const Node* child = node->findChild(path[0]);
+        if (child && path.compare(0, child->prefix.size(), child->prefix) == 0 &&
+            matchNode(child, path.substr(child->prefix.size()), methodIndex, match)) {
+            return true;
+        }
+
+        if (node->param) {
+            std::string_view segment = path.substr(0, path.find('/'));
+            if (!segment.empty()) {
+                match.params.push(node->paramName, segment);
+                if (matchNode(node->param.get(), path.substr(segment.size()), methodIndex, match)) {
+                    return true;
+                }
+                match.params.pop();
+            }
+        }
+    }
+
+    if (node->wildcard) {
+        int32_t handler = handlerFor(node->wildcard.get(), methodIndex);
+        if (handler >= 0) {
+            match.params.push(node->wildcardName, path);
+            match.route = routes[handler].get();
+            return true;
+        }
+        match.allowed |= node->wildcard->allowedMethods();
+    }
+    return false;
+}
+
+Router::Match Router::match(HttpMethod method, std::string_view path) const {
+    Match result;
+    if (method != HttpMethod::UNKNOWN && matchNode(root.get(), path, static_cast<size_t>(method), result)) {
+        result.allowed = 0;
+    }
+    return result;
+}
+
+std::string Router::formatAllowed(uint32_t allowed) {
+    std::string out;
+    for (size_t i = 0; i < METHOD_COUNT; ++i) {
+        if (allowed & (1u << i)) {
+            if (!out.empty()) {
+                out += ", ";
+            }
+            out += HttpRequest::methodToString(static_cast<HttpMethod>(i));
+        }
+    }
+    return out;
+}
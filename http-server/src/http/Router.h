@@ -0,0 +1,103 @@
+// src/http/Router.h
+#pragma once
+#include "Request.h"
+#include "Response.h"
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Values captured by ":name" and "*name" segments of a route pattern. They
+// point into the request path and hold at most MAX_PARAMS entries, so a
+// match never allocates.
+class RouteParams {
+public:
+    static constexpr size_t MAX_PARAMS = 8;
+
+    // Empty if the pattern has no such parameter
+    std::string_view get(std::string_view name) const;
+    size_t size() const { return count; }
+
+    void push(std::string_view name, std::string_view value) { items[count++] = {name, value}; }
+    void pop() { --count; }
+    void clear() { count = 0; }
+
+private:
+    std::array<std::pair<std::string_view, std::string_view>, MAX_PARAMS> items;
+    size_t count = 0;
+};
+
+using RouteHandler = std::function<HttpResponse(const HttpRequest& request, const RouteParams& params)>;
+
+// Method and path dispatch over a radix trie. Patterns are literal text
+// plus "/:name" segments, which match one non-empty path segment, and a
+// final "/*name", which matches the rest of the path, possibly empty. At
+// each node a literal match is preferred over a parameter, and a parameter
+// over a wildcard, backtracking when a branch has no handler for the
+// method.
+//
+// Routes are added during startup; freeze() makes the table read-only, so
+// any number of threads can match against it without locking.
+class Router {
+public:
+    static constexpr size_t METHOD_COUNT = static_cast<size_t>(HttpMethod::UNKNOWN);
+
+    struct Route {
+        std::string pattern;
+        RouteHandler handler;   // Empty for a route the caller dispatches itself
+        size_t tag;             // Caller's id for the route, e.g. a metrics slot
+    };
+
+    struct Match {
+        const Route* route = nullptr;   // Null if nothing handles this method and path
+        RouteParams params;
+        uint32_t allowed = 0;           // Without a route: every method some route takes for the path, by bit
+    };
+
+    Router();
+    ~Router();
+
+    Router(const Router&) = delete;
+    Router& operator=(const Router&) = delete;
+
+    // Throws std::logic_error on a malformed or conflicting pattern, or
+    // once the router is frozen. The route stays at the same address for
+    // the router's lifetime.
+    const Route& add(HttpMethod method, const std::string& pattern, RouteHandler handler, size_t tag = 0);
+    void freeze() { frozen = true; }
+
+    // HEAD falls back to the GET handler when none is registered for it
+    Match match(HttpMethod method, std::string_view path) const;
+
+    // "GET, HEAD, POST" for an allowed bitmask
+    static std::string formatAllowed(uint32_t allowed);
+
+private:
+    struct Node {
+        std::string prefix;                             // Literal text this node consumes
+        std::vector<std::unique_ptr<Node>> children;    // Literal children, distinct first bytes
+        std::string childIndex;                         // First byte of each child, for the scan
+        std::unique_ptr<Node> param;
+        std::string paramName;
+        std::unique_ptr<Node> wildcard;
+        std::string wildcardName;
+        std::array<int32_t, METHOD_COUNT> handlers;     // Index into routes, -1 if none
+
+        Node() { handlers.fill(-1); }
+        Node* findChild(char c) const;
+        uint32_t allowedMethods() const;
+    };
+
+    std::unique_ptr<Node> root;
+    std::vector<std::unique_ptr<Route>> routes;
+    bool frozen;
+
+    Node* insertLiteral(Node* node, std::string_view text);
+    static void split(Node* node, size_t length);
+    bool matchNode(const Node* node, std::string_view path, size_t methodIndex, Match& match) const;
+    int32_t handlerFor(const Node* node, size_t methodIndex) const;
+};
@@ -0,0 +1,227 @@
+// src/http/Scanner.cpp
+#include "Scanner.h"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#define SCANNER_X86 1
+#endif
+
+namespace {
+
+struct TokenTable {
+    bool chars[256];
+
+    TokenTable() : chars() {
+        for (int c = '0'; c <= '9'; ++c) chars[c] = true;
+        for (int c = 'a'; c <= 'z'; ++c) chars[c] = true;
+        for (int c = 'A'; c <= 'Z'; ++c) chars[c] = true;
+        for (unsigned char c : "!#$%&'*+-.^_`|~") {
+            if (c != '\0') chars[c] = true;
+        }
+    }
+};
+
+const TokenTable tokenTable;
+
+bool isTargetChar(unsigned char c) {
+    return c > 0x20 && c < 0x7f;
+}
+
+bool isFieldChar(unsigned char c) {
+    return (c >= 0x20 && c != 0x7f) || c == '\t';
+}
+
+size_t skipTargetScalar(const char* data, size_t pos, size_t end) {
+    while (pos < end && isTargetChar(static_cast<unsigned char>(data[pos]))) pos++;
+    return pos;
+}
+
+size_t skipTokenScalar(const char* data, size_t pos, size_t end) {
+    while (pos < end && tokenTable.chars[static_cast<unsigned char>(data[pos])]) pos++;
+    return pos;
+}
+
+size_t skipFieldScalar(const char* data, size_t pos, size_t end) {
+    while (pos < end && isFieldChar(static_cast<unsigned char>(data[pos]))) pos++;
+    return pos;
+}
+
+#ifdef SCANNER_X86
+
+// SSE2 has no unsigned byte compare, so ranges are tested with min/max:
+// v >= lo exactly when max(v, lo) == v, and v <= hi when min(v, hi) == v
+
+inline __m128i inRange16(__m128i v, unsigned char lo, unsigned char hi) {
+    __m128i geLo = _mm_cmpeq_epi8(_mm_max_epu8(v, _mm_set1_epi8(static_cast<char>(lo))), v);
+    __m128i leHi = _mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(static_cast<char>(hi))), v);
+    return _mm_and_si128(geLo, leHi);
+}
+
+inline __m128i targetMask16(__m128i v) {
+    return inRange16(v, 0x21, 0x7e);
+}
+
+// Letters, digits and '-' cover nearly every header name; the rarer tchar
+// punctuation falls back to the table
+inline __m128i tokenMask16(__m128i v) {
+    __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    __m128i mask = _mm_or_si128(inRange16(lower, 'a', 'z'), inRange16(v, '0', '9'));
+    return _mm_or_si128(mask, _mm_cmpeq_epi8(v, _mm_set1_epi8('-')));
+}
+
+inline __m128i fieldMask16(__m128i v) {
+    __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(0x1f)), v);
+    control = _mm_andnot_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\t')), control);
+    __m128i bad = _mm_or_si128(control, _mm_cmpeq_epi8(v, _mm_set1_epi8(0x7f)));
+    return _mm_xor_si128(bad, _mm_set1_epi8(-1));
+}
+
+// Advances 16 bytes at a time while every byte matches; returns the offset
+// of the first mismatch within the last block, or where the blocks ran out
+template <__m128i (*Mask)(__m128i)>
+size_t skipSse2(const char* data, size_t pos, size_t end) {
+    while (pos + 16 <= end) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        unsigned int misses = ~static_cast<unsigned int>(_mm_movemask_epi8(Mask(v))) & 0xffffu;
+        if (misses != 0) {
+            return pos + static_cast<size_t>(__builtin_ctz(misses));
+        }
+        pos += 16;
+    }
+    return pos;
+}
+
+__attribute__((target("avx2")))
+inline __m256i inRange32(__m256i v, unsigned char lo, unsigned char hi) {
+    __m256i geLo = _mm256_cmpeq_epi8(_mm256_max_epu8(v, _mm256_set1_epi8(static_cast<char>(lo))), v);
+    __m256i leHi = _mm256_cmpeq_epi8(_mm256_min_epu8(v, _mm256_set1_epi8(static_cast<char>(hi))), v);
+    return _mm256_and_si256(geLo, leHi);
+}
+
+__attribute__((target("avx2")))
+inline __m256i targetMask32(__m256i v) {
+    return inRange32(v, 0x21, 0x7e);
+}
+
+__attribute__((target("avx2")))
+inline __m256i tokenMask32(__m256i v) {
+    __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+    __m256i mask = _mm256_or_si256(inRange32(lower, 'a', 'z'), inRange32(v, '0', '9'));
+    return _mm256_or_si256(mask, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('-')));
+}
+
+__attribute__((target("avx2")))
+inline __m256i fieldMask32(__m256i v) {
+    __m256i control = _mm256_cmpeq_epi8(_mm256_min_epu8(v, _mm256_set1_epi8(0x1f)), v);
+    control = _mm256_andnot_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')), control);
+    __m256i bad = _mm256_or_si256(control, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(0x7f)));
+    return _mm256_xor_si256(bad, _mm256_set1_epi8(-1));
+}
+
+template <__m256i (*Mask)(__m256i)>
+__attribute__((target("avx2")))
+size_t skipAvx2(const char* data, size_t pos, size_t end) {
+    while (pos + 32 <= end) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+        unsigned int misses = ~static_cast<unsigned int>(_mm256_movemask_epi8(Mask(v)));
+        if (misses != 0) {
+            return pos + static_cast<size_t>(__builtin_ctz(misses));
+        }
+        pos += 32;
+    }
+    return pos;
+}
+
+size_t skipTargetSse2(const char* data, size_t pos, size_t end) {
+    return skipTargetScalar(data, skipSse2<targetMask16>(data, pos, end), end);
+}
+
+size_t skipTokenSse2(const char* data, size_t pos, size_t end) {
+    while (true) {
+        pos = skipSse2<tokenMask16>(data, pos, end);
+        if (pos + 16 > end) {
+            return skipTokenScalar(data, pos, end);
+        }
+        if (!tokenTable.chars[static_cast<unsigned char>(data[pos])]) {
+            return pos;
+        }
+        pos++;
+    }
+}
+
+size_t skipFieldSse2(const char* data, size_t pos, size_t end) {
+    return skipFieldScalar(data, skipSse2<fieldMask16>(data, pos, end), end);
+}
+
+// The AVX2 versions hand their tail (under 32 bytes) to the SSE2 ones
+size_t skipTargetAvx2(const char* data, size_t pos, size_t end) {
+    return skipTargetSse2(data, skipAvx2<targetMask32>(data, pos, end), end);
+}
+
+size_t skipTokenAvx2(const char* data, size_t pos, size_t end) {
+    while (true) {
+        pos = skipAvx2<tokenMask32>(data, pos, end);
+        if (pos + 32 > end) {
+            return skipTokenSse2(data, pos, end);
+        }
+        if (!tokenTable.chars[static_cast<unsigned char>(data[pos])]) {
+            return pos;
+        }
+        pos++;
+    }
+}
+
+size_t skipFieldAvx2(const char* data, size_t pos, size_t end) {
+    return skipFieldSse2(data, skipAvx2<fieldMask32>(data, pos, end), end);
+}
+
+#endif
+
+using SkipFunction = size_t (*)(const char*, size_t, size_t);
+
+struct Implementation {
+    const char* name;
+    SkipFunction skipTarget;
+    SkipFunction skipToken;
+    SkipFunction skipField;
+};
+
+Implementation selectImplementation() {
+#ifdef SCANNER_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {"avx2", skipTargetAvx2, skipTokenAvx2, skipFieldAvx2};
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return {"sse2", skipTargetSse2, skipTokenSse2, skipFieldSse2};
+    }
+#endif
+    return {"scalar", skipTargetScalar, skipTokenScalar, skipFieldScalar};
+}
+
+const Implementation& implementation() {
+    static const Implementation selected = selectImplementation();
+    return selected;
+}
+
+}
+
+size_t Scanner::skipTargetChars(const char* data, size_t pos, size_t end) {
+    return implementation().skipTarget(data, pos, end);
+}
+
+size_t Scanner::skipTokenChars(const char* data, size_t pos, size_t end) {
+    return implementation().skipToken(data, pos, end);
+}
+
+size_t Scanner::skipFieldChars(const char* data, size_t pos, size_t end) {
+    return implementation().skipField(data, pos, end);
+}
+
+bool Scanner::isTokenChar(unsigned char c) {
+    return tokenTable.chars[c];
+}
+
+const char* Scanner::getImplementation() {
+    return implementation().name;
+}
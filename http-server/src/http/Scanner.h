@@ -0,0 +1,24 @@
+// src/http/Scanner.h
+#pragma once
+#include <cstddef>
+
+// Character-class scanners used by the request parser. Each skip function
+// returns the offset of the first byte in [pos, end) outside its class, or
+// end. On x86 they compare 16 or 32 bytes at a time; the widest version
+// the CPU supports is picked once at startup.
+class Scanner {
+public:
+    // request-target: visible ASCII
+    static size_t skipTargetChars(const char* data, size_t pos, size_t end);
+
+    // Header names and methods: RFC 9110 tchar
+    static size_t skipTokenChars(const char* data, size_t pos, size_t end);
+
+    // Header values: visible characters, obs-text, SP and HTAB
+    static size_t skipFieldChars(const char* data, size_t pos, size_t end);
+
+    static bool isTokenChar(unsigned char c);
+
+    // "avx2", "sse2" or "scalar"
+    static const char* getImplementation();
+};
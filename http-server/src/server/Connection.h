@@ -0,0 +1,214 @@
+// src/server/Connection.h
+#pragma once
+#include <string>
+#include <deque>
+#include <cstddef>
+#include <cstdint>
+#include <chrono>
+#include <memory>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include "../utils/FileHandler.h"
+#include "../http/Response.h"
+#include "../http/RequestParser.h"
+#include "../http/Request.h"
+#include "../http/Router.h"
+#include <vector>
+
+struct Reactor;
+
+// One piece of queued output: serialized bytes, a slice of bytes shared
+// with the file cache, or a region of an open file handed to sendfile.
+struct OutputChunk {
+    std::string data;
+    std::shared_ptr<const std::string> shared;
+    size_t sharedOffset;
+    size_t sharedLength;
+    std::shared_ptr<FileHandle> file;
+    off_t fileOffset;
+    size_t fileRemaining;
+
+    explicit OutputChunk(std::string bytes)
+        : data(std::move(bytes)), sharedOffset(0), sharedLength(0), fileOffset(0), fileRemaining(0) {}
+
+    explicit OutputChunk(const BodySegment& segment)
+        : data(segment.shared || segment.file ? std::string() : segment.data),
+          shared(segment.shared), sharedOffset(segment.offset), sharedLength(segment.length),
+          file(segment.file), fileOffset(static_cast<off_t>(segment.offset)), fileRemaining(segment.length) {}
+
+    bool isFile() const { return file != nullptr; }
+    const char* bytes() const { return shared ? shared->data() + sharedOffset : data.data(); }
+    size_t size() const { return shared ? sharedLength : data.size(); }
+};
+
+// Collects the output of one worker task. Response heads are serialized
+// back to back into a single buffer and queued as slices of it; bodies are
+// queued by reference, so the writer gathers everything with one sendmsg
+// and no body is copied.
+class OutputBuilder {
+private:
+    std::string headBlock;
+    std::vector<OutputChunk> chunks;
+    std::vector<size_t> headChunks;     // Indexes of chunks that slice headBlock
+
+public:
+    OutputBuilder() { headBlock.reserve(1024); }
+
+    void addHead(const HttpResponse& response) {
+        size_t offset = headBlock.size();
+        response.serializeHead(headBlock);
+        BodySegment slice;
+        slice.offset = offset;
+        slice.length = headBlock.size() - offset;
+        headChunks.push_back(chunks.size());
+        chunks.emplace_back(slice);
+    }
+
+    void addBody(HttpResponse& response) {
+        std::string body = response.takeBody();
+        if (!body.empty()) {
+            chunks.emplace_back(std::move(body));
+        }
+        for (const auto& segment : response.getBodySegments()) {
+            if (segment.length > 0) {
+                chunks.emplace_back(segment);
+            }
+        }
+    }
+
+    void addData(std::string bytes) {
+        chunks.emplace_back(std::move(bytes));
+    }
+
+    // Hands the queued chunks over, pointing the head slices at the buffer
+    std::vector<OutputChunk> finish() {
+        auto block = std::make_shared<const std::string>(std::move(headBlock));
+        for (size_t index : headChunks) {
+            chunks[index].shared = block;
+        }
+        headChunks.clear();
+        return std::move(chunks);
+    }
+};
+
+// A pipe that carries file bytes from the page cache to a socket when the
+// io_uring backend splices instead of calling sendfile. Reactors keep the
+// empty ones for reuse.
+struct SplicePipe {
+    int readFd = -1;
+    int writeFd = -1;
+    size_t capacity = 0;
+
+    bool isOpen() const { return readFd >= 0; }
+};
+
+// Requests carved off a connection for one worker task, plus the streamed
+// response it stopped in the middle of, if any. A batch with a producer
+// is parked on the connection until the socket drains, then handed back
+// to the pool to generate the next piece. A batch that reaches a coroutine
+// route is parked until the route's task has finished, then handed back
+// with the response.
+struct WorkBatch {
+    std::vector<HttpRequest> requests;
+    size_t next = 0;            // First request not yet answered
+    size_t served = 0;          // requestsServed when the batch was carved
+    std::chrono::steady_clock::time_point received;     // When the batch was carved
+    BodyProducer producer;      // Body still being streamed for requests[next - 1]
+    bool chunked = false;
+    bool keepAlive = true;
+    size_t streamRoute = 0;     // Route, status and body bytes of the streamed response so far
+    int streamStatus = 0;
+    uint64_t streamedBytes = 0;
+    const Router::Route* asyncRoute = nullptr;      // Coroutine route requests[next] is waiting on
+    RouteParams asyncParams;                        // Its parameters, valid while the task runs
+    std::unique_ptr<HttpResponse> asyncResponse;    // What the task produced for requests[next]
+};
+
+// Per-client state owned by the event loop thread. Workers never touch a
+// Connection directly; they receive a copy of the request bytes and post the
+// response chunks back to the loop.
+struct Connection {
+    Reactor* reactor;       // Loop that accepted the connection and owns it
+    int fd;
+    std::string clientIP;
+
+    // Bytes received but not yet handed to a worker. Pipelined requests are
+    // carved off the front; whatever follows the last complete request stays
+    // here for the next read.
+    std::string inBuffer;
+    size_t requestStart;    // Start of the request currently being framed
+    RequestParser parser;   // Parse state of that request, resumed on each read
+
+    // Response chunks waiting to be written, in request order
+    std::deque<OutputChunk> outQueue;
+    size_t outOffset;       // Bytes of a data chunk at the front already written
+
+    // Streamed response waiting for outQueue to drain before it continues
+    std::shared_ptr<WorkBatch> pendingWork;
+
+    size_t requestsServed;
+    std::chrono::steady_clock::time_point acceptedAt;
+    std::chrono::steady_clock::time_point lastActivity;     // Last read, queued response or write progress
+
+    bool processing;        // A batch of requests is being handled by a worker
+    bool continueSent;      // 100 Continue already sent for the current request
+    bool closeAfterWrite;
+    bool peerClosed;
+    bool closed;
+    bool firstByteSent;     // Accept-to-first-byte already recorded
+    bool readPaused;        // inBuffer full; the socket is left unread until it drains
+
+    // io_uring backend only. The connection stays registered with its
+    // reactor by id until every operation it submitted has completed, since
+    // the kernel may still be reading the iovecs and message below.
+    struct RingState {
+        uint64_t id = 0;
+        bool receiving = false;     // Multishot receive armed
+        bool closing = false;       // Close submitted, not yet completed
+        unsigned writes = 0;        // Operations of the current write still owed a completion
+        SplicePipe pipe;            // Held while a file chunk is being spliced
+        size_t pipeBytes = 0;       // Spliced in from the file, not yet out to the socket
+        std::vector<iovec> iov;
+        msghdr message{};
+    } ring;
+
+    Connection(Reactor* owner, int socketFd, const std::string& ip)
+        : reactor(owner), fd(socketFd), clientIP(ip), requestStart(0), outOffset(0), requestsServed(0),
+          acceptedAt(std::chrono::steady_clock::now()), lastActivity(acceptedAt),
+          processing(false), continueSent(false), closeAfterWrite(false), peerClosed(false), closed(false),
+          firstByteSent(false), readPaused(false) {}
+
+    // Advance past a fully framed request
+    void nextRequest(size_t requestLength) {
+        requestStart += requestLength;
+        parser.reset();
+        continueSent = false;
+    }
+
+    // Drop the bytes before requestStart. The parser works relative to the
+    // start of the request, so its partial state stays valid.
+    void compactInput() {
+        if (requestStart == 0) {
+            return;
+        }
+        inBuffer.erase(0, requestStart);
+        requestStart = 0;
+    }
+
+    void discardInput() {
+        inBuffer.clear();
+        requestStart = 0;
+        nextRequest(0);
+    }
+
+    bool hasPendingOutput() const { return !outQueue.empty(); }
+
+    size_t queuedBytes() const {
+        size_t total = 0;
+        for (const auto& chunk : outQueue) {
+            total += chunk.isFile() ? chunk.fileRemaining : chunk.size();
+        }
+        return total - outOffset;
+    }
+};
@@ -0,0 +1,104 @@
+// src/server/EventLoop.cpp
+#include "EventLoop.h"
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cerrno>
+
+namespace {
+thread_local EventLoop* currentLoop = nullptr;
+}
+
+EventLoop::EventLoop() : epollFd(-1), wakeupFd(-1) {}
+
+EventLoop::~EventLoop() {
+    if (wakeupFd >= 0) ::close(wakeupFd);
+    if (epollFd >= 0) ::close(epollFd);
+}
+
+bool EventLoop::create() {
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        return false;
+    }
+
+    wakeupFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeupFd < 0) {
+        return false;
+    }
+
+    return add(wakeupFd, EPOLLIN | EPOLLET);
+}
+
+bool EventLoop::add(int fd, uint32_t events) {
+    epoll_event ev{};
+    ev.events = events;
+    ev.data.fd = fd;
+    return epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) == 0;
+}
+
+bool EventLoop::modify(int fd, uint32_t events) {
+    epoll_event ev{};
+    ev.events = events;
+    ev.data.fd = fd;
+    return epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev) == 0;
+}
+
+void EventLoop::remove(int fd) {
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+int EventLoop::wait(std::vector<epoll_event>& events, int timeoutMs) {
+    int n = epoll_wait(epollFd, events.data(), static_cast<int>(events.size()), timeoutMs);
+    if (n < 0 && errno == EINTR) {
+        return 0;
+    }
+    return n;
+}
+
+void EventLoop::post(Callback callback) {
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        pending.push_back(std::move(callback));
+    }
+    wakeup();
+}
+
+void EventLoop::wakeup() {
+    uint64_t one = 1;
+    ssize_t n = ::write(wakeupFd, &one, sizeof(one));
+    (void)n;
+}
+
+void EventLoop::runPending() {
+    // Drain the eventfd counter so the next post() triggers a new edge
+    uint64_t count;
+    while (::read(wakeupFd, &count, sizeof(count)) > 0) {}
+
+    std::vector<Callback> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        callbacks.swap(pending);
+    }
+
+    for (auto& callback : callbacks) {
+        callback();
+    }
+}
+
+void EventLoop::runDeferred() {
+    // Callbacks deferred while these run wait for the next round, so a
+    // long stream cannot starve the other sockets on this loop
+    std::vector<Callback> callbacks;
+    callbacks.swap(deferred);
+    for (auto& callback : callbacks) {
+        callback();
+    }
+}
+
+EventLoop* EventLoop::current() {
+    return currentLoop;
+}
+
+void EventLoop::makeCurrent() {
+    currentLoop = this;
+}
@@ -0,0 +1,53 @@
+// src/server/EventLoop.h
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include <sys/epoll.h>
+
+// Thin wrapper around an epoll instance plus an eventfd used to wake the
+// loop when other threads post work to it.
+class EventLoop {
+public:
+    using Callback = std::function<void()>;
+
+    EventLoop();
+    ~EventLoop();
+
+    bool create();
+
+    bool add(int fd, uint32_t events);
+    bool modify(int fd, uint32_t events);
+    void remove(int fd);
+
+    // Blocks until at least one event is ready or the timeout expires.
+    int wait(std::vector<epoll_event>& events, int timeoutMs);
+
+    // Thread-safe: queue a callback to run on the loop thread and wake it.
+    void post(Callback callback);
+    void wakeup();
+
+    // Runs queued callbacks; called by the loop thread after a wakeup.
+    void runPending();
+
+    // Loop thread only: queue a callback for after the current round of
+    // events, without touching the eventfd.
+    void defer(Callback callback) { deferred.push_back(std::move(callback)); }
+    bool hasDeferred() const { return !deferred.empty(); }
+    void runDeferred();
+
+    int getWakeupFD() const { return wakeupFd; }
+
+    // The loop the calling thread runs, null on threads that run none.
+    // makeCurrent() is called by the thread that is about to run the loop.
+    static EventLoop* current();
+    void makeCurrent();
+
+private:
+    int epollFd;
+    int wakeupFd;
+    std::mutex pendingMutex;
+    std::vector<Callback> pending;
+    std::vector<Callback> deferred;
+};
@@ -0,0 +1,406 @@
+// src/server/IoUring.cpp
+#include "IoUring.h"
+
+#ifdef HAVE_IO_URING
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+#include <poll.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+const uint16_t BUFFER_GROUP = 0;
+
+int ringSetup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+int ringRegister(int fd, unsigned opcode, void* arg, unsigned count) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+// Multishot receive arrived in 6.0 and the opcode probe can't tell it
+// apart from plain receive, so the kernel version has to decide
+bool kernelAtLeast(int major, int minor) {
+    utsname name;
+    int haveMajor = 0;
+    int haveMinor = 0;
+    if (uname(&name) != 0 || sscanf(name.release, "%d.%d", &haveMajor, &haveMinor) != 2) {
+        return false;
+    }
+    return haveMajor > major || (haveMajor == major && haveMinor >= minor);
+}
+
+} // namespace
+
+struct IoUring::Ring {
+    int fd = -1;
+
+    void* sqMap = MAP_FAILED;
+    size_t sqMapSize = 0;
+    void* cqMap = MAP_FAILED;
+    size_t cqMapSize = 0;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t sqesSize = 0;
+
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned sqMask = 0;
+    unsigned sqEntries = 0;
+    unsigned sqeTail = 0;       // Next entry to fill
+    unsigned submitted = 0;     // Entries the kernel has taken
+
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned cqMask = 0;
+    io_uring_cqe* cqes = nullptr;
+
+    io_uring_buf_ring* bufferRing = static_cast<io_uring_buf_ring*>(MAP_FAILED);
+    size_t bufferRingSize = 0;
+    unsigned bufferCount = 0;
+    unsigned bufferSize = 0;
+    uint16_t bufferTail = 0;
+    std::unique_ptr<char[]> buffers;
+
+    __kernel_timespec tick{};
+
+    ~Ring() {
+        if (bufferRing != MAP_FAILED) munmap(bufferRing, bufferRingSize);
+        if (sqes != MAP_FAILED) munmap(sqes, sqesSize);
+        if (cqMap != MAP_FAILED && cqMap != sqMap) munmap(cqMap, cqMapSize);
+        if (sqMap != MAP_FAILED) munmap(sqMap, sqMapSize);
+        if (fd >= 0) ::close(fd);
+    }
+
+    bool map(const io_uring_params& params) {
+        sqMapSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqMapSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (singleMap) {
+            sqMapSize = cqMapSize = std::max(sqMapSize, cqMapSize);
+        }
+
+        sqMap = mmap(nullptr, sqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (sqMap == MAP_FAILED) {
+            return false;
+        }
+        cqMap = singleMap ? sqMap
+                          : mmap(nullptr, cqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                                 IORING_OFF_CQ_RING);
+        if (cqMap == MAP_FAILED) {
+            return false;
+        }
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = static_cast<io_uring_sqe*>(mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE,
+                                               MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+        if (sqes == MAP_FAILED) {
+            return false;
+        }
+
+        char* sq = static_cast<char*>(sqMap);
+        sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqEntries = params.sq_entries;
+        sqeTail = submitted = *sqTail;
+
+        char* cq = static_cast<char*>(cqMap);
+        cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    bool supportsOps(std::string& error) {
+        size_t size = sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op);
+        std::vector<char> storage(size, 0);
+        auto* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+        if (ringRegister(fd, IORING_REGISTER_PROBE, probe, 256) < 0) {
+            error = "opcode probe failed";
+            return false;
+        }
+
+        const struct {
+            int op;
+            const char* name;
+        } needed[] = {
+            {IORING_OP_ACCEPT, "accept"},
+            {IORING_OP_RECV, "recv"},
+            {IORING_OP_SENDMSG, "sendmsg"},
+            {IORING_OP_SPLICE, "splice"},
+            {IORING_OP_CLOSE, "close"},
+            {IORING_OP_ASYNC_CANCEL, "cancel"},
+            {IORING_OP_POLL_ADD, "poll"},
+            {IORING_OP_TIMEOUT, "timeout"},
+        };
+        for (const auto& op : needed) {
+            if (op.op > probe->last_op || !(probe->ops[op.op].flags & IO_URING_OP_SUPPORTED)) {
+                error = std::string("no ") + op.name + " operation";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool registerBuffers(unsigned count, unsigned size) {
+        bufferCount = count;
+        bufferSize = size;
+        bufferRingSize = count * sizeof(io_uring_buf);
+        bufferRing = static_cast<io_uring_buf_ring*>(mmap(nullptr, bufferRingSize, PROT_READ | PROT_WRITE,
+                                                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        if (bufferRing == MAP_FAILED) {
+            return false;
+        }
+
+        io_uring_buf_reg reg{};
+        reg.ring_addr = reinterpret_cast<uint64_t>(bufferRing);
+        reg.ring_entries = count;
+        reg.bgid = BUFFER_GROUP;
+        if (ringRegister(fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+            return false;
+        }
+
+        buffers.reset(new char[static_cast<size_t>(count) * size]);
+        for (unsigned i = 0; i < count; ++i) {
+            addBuffer(static_cast<int>(i));
+        }
+        publishBuffers();
+        return true;
+    }
+
+    void addBuffer(int id) {
+        // Slots start at the top of the ring, the tail sharing the first
+        // one's reserved field. The header's bufs member can't be used for
+        // this: the empty struct in its flexible array macro shifts it in C++.
+        io_uring_buf* slots = reinterpret_cast<io_uring_buf*>(bufferRing);
+        io_uring_buf& buffer = slots[bufferTail & (bufferCount - 1)];
+        buffer.addr = reinterpret_cast<uint64_t>(buffers.get() + static_cast<size_t>(id) * bufferSize);
+        buffer.len = bufferSize;
+        buffer.bid = static_cast<uint16_t>(id);
+        bufferTail++;
+    }
+
+    void publishBuffers() {
+        __atomic_store_n(&bufferRing->tail, bufferTail, __ATOMIC_RELEASE);
+    }
+
+    // Hands filled entries to the kernel, which consumes them all during
+    // the call unless it fails
+    int enter(unsigned waitFor) {
+        __atomic_store_n(sqTail, sqeTail, __ATOMIC_RELEASE);
+        unsigned pending = sqeTail - submitted;
+        // GETEVENTS even without waiting: it is what runs the completion
+        // work the kernel deferred to this thread
+        int taken = ringEnter(fd, pending, waitFor, IORING_ENTER_GETEVENTS);
+        if (taken > 0) {
+            submitted += static_cast<unsigned>(taken);
+        }
+        return taken;
+    }
+
+    io_uring_sqe* nextSqe() {
+        // A full queue goes to the kernel early rather than overwriting
+        // entries it has not read yet
+        while (sqeTail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= sqEntries) {
+            if (enter(0) < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                break;
+            }
+        }
+        unsigned index = sqeTail & sqMask;
+        io_uring_sqe* sqe = &sqes[index];
+        memset(sqe, 0, sizeof(*sqe));
+        sqArray[index] = index;
+        sqeTail++;
+        return sqe;
+    }
+};
+
+IoUring::IoUring() = default;
+
+IoUring::~IoUring() = default;
+
+bool IoUring::create(unsigned entries, unsigned bufferCount, unsigned bufferSize, std::string& error) {
+    if (!kernelAtLeast(6, 0)) {
+        error = "kernel older than 6.0";
+        return false;
+    }
+
+    std::unique_ptr<Ring> created(new Ring());
+    io_uring_params params{};
+    params.flags = IORING_SETUP_CLAMP | IORING_SETUP_COOP_TASKRUN;
+    created->fd = ringSetup(entries, &params);
+    if (created->fd < 0) {
+        error = std::string("io_uring_setup: ") + strerror(errno);
+        return false;
+    }
+    if (!(params.features & IORING_FEAT_NODROP) || !(params.features & IORING_FEAT_FAST_POLL)) {
+        error = "kernel lacks IORING_FEAT_NODROP or IORING_FEAT_FAST_POLL";
+        return false;
+    }
+    if (!created->map(params)) {
+        error = std::string("mmap: ") + strerror(errno);
+        return false;
+    }
+    if (!created->supportsOps(error)) {
+        return false;
+    }
+    if (!created->registerBuffers(bufferCount, bufferSize)) {
+        error = std::string("provided buffer ring: ") + strerror(errno);
+        return false;
+    }
+
+    ring = std::move(created);
+    return true;
+}
+
+void IoUring::accept(int listenFd, uint64_t userData) {
+    io_uring_sqe* sqe = ring->nextSqe();
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = listenFd;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->user_data = userData;
+}
+
+void IoUring::receive(int fd, uint64_t userData) {
+    io_uring_sqe* sqe = ring->nextSqe();
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = fd;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUFFER_GROUP;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->user_data = userData;
+}
+
+void IoUring::pollReadable(int fd, uint64_t userData) {
+    io_uring_sqe* sqe = ring->nextSqe();
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    sqe->poll32_events = POLLIN;
+    sqe->len = IORING_POLL_ADD_MULTI;
+    sqe->user_data = userData;
+}
+
+void IoUring::sendmsg(int fd, const msghdr* message, int flags, uint64_t userData) {
+    io_uring_sqe* sqe = ring->nextSqe();
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(message);
+    sqe->len = 1;
+    sqe->msg_flags = static_cast<uint32_t>(flags);
+    sqe->user_data = userData;
+}
+
+void IoUring::splice(int fdIn, int64_t offsetIn, int fdOut, unsigned length, uint64_t userData, bool linkNext) {
+    io_uring_sqe* sqe = ring->nextSqe();
+    sqe->opcode = IORING_OP_SPLICE;
+    sqe->fd = fdOut;
+    sqe->off = static_cast<uint64_t>(-1);
+    sqe->splice_fd_in = fdIn;
+    sqe->splice_off_in = static_cast<uint64_t>(offsetIn);
+    sqe->len = length;
+    sqe->flags = linkNext ? IOSQE_IO_LINK : 0;
+    sqe->user_data = userData;
+}
+
+void IoUring::close(int fd, uint64_t userData) {
+    io_uring_sqe* sqe = ring->nextSqe();
+    sqe->opcode = IORING_OP_CLOSE;
+    sqe->fd = fd;
+    sqe->user_data = userData;
+}
+
+void IoUring::cancel(uint64_t target, uint64_t userData) {
+    io_uring_sqe* sqe = ring->nextSqe();
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = target;
+    sqe->user_data = userData;
+}
+
+void IoUring::timeout(unsigned milliseconds, uint64_t userData) {
+    ring->tick.tv_sec = milliseconds / 1000;
+    ring->tick.tv_nsec = static_cast<long long>(milliseconds % 1000) * 1000000;
+    io_uring_sqe* sqe = ring->nextSqe();
+    sqe->opcode = IORING_OP_TIMEOUT;
+    sqe->fd = -1;
+    sqe->addr = reinterpret_cast<uint64_t>(&ring->tick);
+    sqe->len = 1;
+    sqe->user_data = userData;
+}
+
+bool IoUring::submit(unsigned waitFor) {
+    if (ring->enter(waitFor) >= 0) {
+        return true;
+    }
+    // Interrupted, or completions backed up; the caller reaps and retries
+    return errno == EINTR || errno == EAGAIN || errno == EBUSY || errno == ETIME;
+}
+
+bool IoUring::nextCompletion(RingCompletion& completion) {
+    unsigned head = *ring->cqHead;
+    if (head == __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+    const io_uring_cqe& cqe = ring->cqes[head & ring->cqMask];
+    completion.userData = cqe.user_data;
+    completion.result = cqe.res;
+    completion.more = cqe.flags & IORING_CQE_F_MORE;
+    completion.buffer = (cqe.flags & IORING_CQE_F_BUFFER) ? static_cast<int>(cqe.flags >> IORING_CQE_BUFFER_SHIFT) : -1;
+    __atomic_store_n(ring->cqHead, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+const char* IoUring::bufferData(int buffer) const {
+    return ring->buffers.get() + static_cast<size_t>(buffer) * ring->bufferSize;
+}
+
+void IoUring::releaseBuffer(int buffer) {
+    ring->addBuffer(buffer);
+    ring->publishBuffers();
+}
+
+#else
+
+// Built without linux/io_uring.h: create() always fails and the server
+// stays on epoll
+
+struct IoUring::Ring {};
+
+IoUring::IoUring() = default;
+IoUring::~IoUring() = default;
+
+bool IoUring::create(unsigned, unsigned, unsigned, std::string& error) {
+    error = "built without io_uring support";
+    return false;
+}
+
+void IoUring::accept(int, uint64_t) {}
+void IoUring::receive(int, uint64_t) {}
+void IoUring::pollReadable(int, uint64_t) {}
+void IoUring::sendmsg(int, const msghdr*, int, uint64_t) {}
+void IoUring::splice(int, int64_t, int, unsigned, uint64_t, bool) {}
+void IoUring::close(int, uint64_t) {}
+void IoUring::cancel(uint64_t, uint64_t) {}
+void IoUring::timeout(unsigned, uint64_t) {}
+bool IoUring::submit(unsigned) { return false; }
+bool IoUring::nextCompletion(RingCompletion&) { return false; }
+const char* IoUring::bufferData(int) const { return nullptr; }
+void IoUring::releaseBuffer(int) {}
+
+#endif
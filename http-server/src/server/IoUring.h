@@ -0,0 +1,74 @@
+// src/server/IoUring.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <sys/socket.h>
+
+// One completion taken off the ring
+struct RingCompletion {
+    uint64_t userData;
+    int32_t result;     // Bytes transferred, a new fd, or -errno
+    bool more;          // A multishot operation is still armed after this one
+    int buffer;         // Provided buffer holding received bytes, -1 if none
+};
+
+// Thin wrapper around an io_uring instance, driven through the raw system
+// calls so there is no dependency on liburing. Operations are queued into
+// the submission ring and reach the kernel together on the next submit(),
+// so one system call covers every accept, receive, send and close of a
+// loop iteration.
+//
+// Receives draw from a ring of provided buffers registered with the kernel;
+// a buffer named by a completion belongs to the caller until it is handed
+// back with releaseBuffer().
+class IoUring {
+public:
+    IoUring();
+    ~IoUring();
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    // Fails, with the reason in error, when the kernel lacks something the
+    // server relies on: multishot accept and receive, provided buffer rings
+    // or splice. The caller falls back to epoll.
+    bool create(unsigned entries, unsigned bufferCount, unsigned bufferSize, std::string& error);
+
+    // Multishot: one completion per accepted connection
+    void accept(int listenFd, uint64_t userData);
+
+    // Multishot: one completion per read, into a provided buffer
+    void receive(int fd, uint64_t userData);
+
+    // Multishot: one completion each time fd becomes readable
+    void pollReadable(int fd, uint64_t userData);
+
+    // message and everything it points to must stay valid until completion
+    void sendmsg(int fd, const msghdr* message, int flags, uint64_t userData);
+
+    // offsetIn is -1 for a pipe or socket. With linkNext the next operation
+    // queued only starts once this one has moved all length bytes.
+    void splice(int fdIn, int64_t offsetIn, int fdOut, unsigned length, uint64_t userData, bool linkNext);
+
+    void close(int fd, uint64_t userData);
+    void cancel(uint64_t target, uint64_t userData);
+
+    // Completes with -ETIME after the given time; one may be pending at once
+    void timeout(unsigned milliseconds, uint64_t userData);
+
+    // Hands queued operations to the kernel and waits until at least
+    // waitFor completions are ready. False on an unrecoverable ring error.
+    bool submit(unsigned waitFor);
+
+    // Takes the next ready completion, if any
+    bool nextCompletion(RingCompletion& completion);
+
+    const char* bufferData(int buffer) const;
+    void releaseBuffer(int buffer);
+
+private:
+    struct Ring;
+    std::unique_ptr<Ring> ring;
+};
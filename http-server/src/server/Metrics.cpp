@@ -0,0 +1,331 @@
+// src/server/Metrics.cpp
+#include "Metrics.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <sched.h>
+
+namespace {
+
+const char* const COUNTER_NAMES[] = {
+    "connections_opened",
+    "connections_closed",
+    "bytes_received",
+    "bytes_sent",
+};
+
+const char* const COUNTER_HELP[] = {
+    "Connections accepted",
+    "Connections closed",
+    "Bytes read from clients",
+    "Bytes written to clients",
+};
+
+// Prometheus bucket boundaries, in microseconds
+const uint64_t EXPORT_BOUNDS[] = {
+    100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000,
+    100000, 250000, 500000, 1000000, 2500000, 5000000, 10000000,
+};
+
+const double EXPORT_PERCENTILES[] = {0.5, 0.9, 0.99, 0.999};
+
+std::string formatDouble(double value) {
+    // Counters are printed whole and everything else with enough digits
+    // that a growing total still changes between scrapes
+    char buffer[32];
+    if (value == std::floor(value) && std::fabs(value) < 1e15) {
+        snprintf(buffer, sizeof(buffer), "%.0f", value);
+    } else {
+        snprintf(buffer, sizeof(buffer), "%.15g", value);
+    }
+    return buffer;
+}
+
+std::string formatSeconds(uint64_t micros) {
+    return formatDouble(static_cast<double>(micros) / 1e6);
+}
+
+// JSON keys follow the camelCase of the other API endpoints
+std::string camelCase(const std::string& name) {
+    std::string out;
+    bool upper = false;
+    for (char c : name) {
+        if (c == '_') {
+            upper = true;
+        } else {
+            out += upper ? static_cast<char>(toupper(static_cast<unsigned char>(c))) : c;
+            upper = false;
+        }
+    }
+    return out;
+}
+
+std::string statusClassLabel(size_t statusClass) {
+    return std::to_string(statusClass + 1) + "xx";
+}
+
+// Route names are fixed strings chosen by the server, but quote them anyway
+std::string escapeLabel(const std::string& value) {
+    std::string out;
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            out += '\\';
+            out += c;
+        } else if (c == '\n') {
+            out += "\\n";
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+void appendHistogram(std::string& out, const std::string& name, const std::string& labels,
+                     const LatencyHistogram::Snapshot& snapshot) {
+    std::string prefix = labels.empty() ? "{" : "{" + labels + ",";
+    for (uint64_t bound : EXPORT_BOUNDS) {
+        out += name + "_bucket" + prefix + "le=\"" + formatSeconds(bound) + "\"} " +
+               std::to_string(snapshot.countAtOrBelow(bound)) + "\n";
+    }
+    out += name + "_bucket" + prefix + "le=\"+Inf\"} " + std::to_string(snapshot.count) + "\n";
+    std::string suffix = labels.empty() ? "" : "{" + labels + "}";
+    out += name + "_sum" + suffix + " " + formatSeconds(snapshot.sum) + "\n";
+    out += name + "_count" + suffix + " " + std::to_string(snapshot.count) + "\n";
+}
+
+void appendHistogramJson(std::string& out, const LatencyHistogram::Snapshot& snapshot) {
+    out += "{\"count\": " + std::to_string(snapshot.count);
+    out += ", \"sumSeconds\": " + formatSeconds(snapshot.sum);
+    for (double fraction : EXPORT_PERCENTILES) {
+        std::string label = formatDouble(fraction * 100);
+        label.erase(std::remove(label.begin(), label.end(), '.'), label.end());
+        out += ", \"p" + label + "Seconds\": " + formatSeconds(snapshot.percentile(fraction));
+    }
+    out += ", \"maxSeconds\": " + formatSeconds(snapshot.max) + "}";
+}
+
+} // namespace
+
+LatencyHistogram::LatencyHistogram() : sum(0), max(0) {
+    for (auto& count : counts) {
+        count.store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t LatencyHistogram::bucketFor(uint64_t micros) {
+    micros = std::min<uint64_t>(micros, UINT32_MAX);
+    if (micros < SUB_BUCKETS) {
+        return static_cast<size_t>(micros);
+    }
+    size_t exponent = 63 - static_cast<size_t>(__builtin_clzll(micros));
+    size_t sub = static_cast<size_t>(micros >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+    return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t bucket) {
+    if (bucket < SUB_BUCKETS) {
+        return bucket;
+    }
+    size_t shift = bucket / SUB_BUCKETS - 1;
+    uint64_t lower = static_cast<uint64_t>(SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+    return lower + (uint64_t(1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t micros) {
+    counts[bucketFor(micros)].fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(micros, std::memory_order_relaxed);
+    uint64_t seen = max.load(std::memory_order_relaxed);
+    while (micros > seen && !max.compare_exchange_weak(seen, micros, std::memory_order_relaxed)) {}
+}
+
+void LatencyHistogram::addTo(Snapshot& snapshot) const {
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        uint64_t count = counts[i].load(std::memory_order_relaxed);
+        snapshot.counts[i] += count;
+        snapshot.count += count;
+    }
+    snapshot.sum += sum.load(std::memory_order_relaxed);
+    snapshot.max = std::max(snapshot.max, max.load(std::memory_order_relaxed));
+}
+
+uint64_t LatencyHistogram::Snapshot::countAtOrBelow(uint64_t micros) const {
+    uint64_t total = 0;
+    for (size_t i = 0; i < BUCKET_COUNT && bucketUpperBound(i) <= micros; ++i) {
+        total += counts[i];
+    }
+    return total;
+}
+
+uint64_t LatencyHistogram::Snapshot::percentile(double fraction) const {
+    if (count == 0) {
+        return 0;
+    }
+    uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(count))));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += counts[i];
+        if (seen >= target) {
+            return std::min(bucketUpperBound(i), max);
+        }
+    }
+    return max;
+}
+
+Metrics::Shard::Shard() {
+    for (auto& counter : counters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+}
+
+Metrics::Metrics(size_t shardCount) {
+    if (shardCount == 0) {
+        shardCount = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), 64);
+    }
+    for (size_t i = 0; i < shardCount; ++i) {
+        shards.push_back(std::make_unique<Shard>());
+    }
+}
+
+size_t Metrics::addRoute(const std::string& name) {
+    routes.push_back(name);
+    for (auto& shard : shards) {
+        for (size_t i = 0; i < STATUS_CLASSES; ++i) {
+            shard->requests.push_back(std::make_unique<LatencyHistogram>());
+        }
+    }
+    return routes.size() - 1;
+}
+
+Metrics::Shard& Metrics::localShard() {
+    // Threads may migrate between the lookup and the add; the shard only
+    // needs to be right most of the time
+    int cpu = sched_getcpu();
+    return *shards[static_cast<size_t>(cpu < 0 ? 0 : cpu) % shards.size()];
+}
+
+void Metrics::add(Counter counter, uint64_t amount) {
+    localShard().counters[counter].fetch_add(amount, std::memory_order_relaxed);
+}
+
+void Metrics::recordRequest(size_t route, int status, uint64_t micros) {
+    if (route >= routes.size()) {
+        return;
+    }
+    size_t statusClass = static_cast<size_t>(std::min(std::max(status / 100, 1), 5) - 1);
+    localShard().requests[route * STATUS_CLASSES + statusClass]->record(micros);
+}
+
+void Metrics::recordFirstByte(uint64_t micros) {
+    localShard().firstByte.record(micros);
+}
+
+uint64_t Metrics::activeConnections() const {
+    // Closes are read first so a connection opened and closed in between
+    // can't make the difference negative
+    uint64_t closed = getCounter(CONNECTIONS_CLOSED);
+    uint64_t opened = getCounter(CONNECTIONS_OPENED);
+    return opened > closed ? opened - closed : 0;
+}
+
+uint64_t Metrics::getCounter(Counter counter) const {
+    uint64_t total = 0;
+    for (const auto& shard : shards) {
+        total += shard->counters[counter].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+LatencyHistogram::Snapshot Metrics::mergeFirstByte() const {
+    LatencyHistogram::Snapshot snapshot;
+    for (const auto& shard : shards) {
+        shard->firstByte.addTo(snapshot);
+    }
+    return snapshot;
+}
+
+LatencyHistogram::Snapshot Metrics::mergeRequests(size_t route, size_t statusClass) const {
+    LatencyHistogram::Snapshot snapshot;
+    for (const auto& shard : shards) {
+        shard->requests[route * STATUS_CLASSES + statusClass]->addTo(snapshot);
+    }
+    return snapshot;
+}
+
+std::string Metrics::renderPrometheus(const std::vector<MetricValue>& extra) const {
+    std::string out;
+    out.reserve(16 * 1024);
+
+    for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+        std::string name = std::string("httpserver_") + COUNTER_NAMES[i] + "_total";
+        out += "# HELP " + name + " " + COUNTER_HELP[i] + "\n";
+        out += "# TYPE " + name + " counter\n";
+        out += name + " " + std::to_string(getCounter(static_cast<Counter>(i))) + "\n";
+    }
+
+    out += "# HELP httpserver_connections_active Connections currently open\n";
+    out += "# TYPE httpserver_connections_active gauge\n";
+    out += "httpserver_connections_active " +
+           std::to_string(activeConnections()) + "\n";
+
+    for (const auto& value : extra) {
+        out += "# HELP httpserver_" + value.name + " " + value.help + "\n";
+        out += "# TYPE httpserver_" + value.name + (value.counter ? " counter\n" : " gauge\n");
+        out += "httpserver_" + value.name + " " + formatDouble(value.value) + "\n";
+    }
+
+    out += "# HELP httpserver_first_byte_seconds Time from accepting a connection to its first response byte\n";
+    out += "# TYPE httpserver_first_byte_seconds histogram\n";
+    appendHistogram(out, "httpserver_first_byte_seconds", "", mergeFirstByte());
+
+    out += "# HELP httpserver_request_duration_seconds Time from framing a request to its response being ready\n";
+    out += "# TYPE httpserver_request_duration_seconds histogram\n";
+    for (size_t route = 0; route < routes.size(); ++route) {
+        for (size_t statusClass = 0; statusClass < STATUS_CLASSES; ++statusClass) {
+            LatencyHistogram::Snapshot snapshot = mergeRequests(route, statusClass);
+            if (snapshot.count == 0) {
+                continue;
+            }
+            std::string labels = "route=\"" + escapeLabel(routes[route]) + "\",status=\"" +
+                                 statusClassLabel(statusClass) + "\"";
+            appendHistogram(out, "httpserver_request_duration_seconds", labels, snapshot);
+        }
+    }
+    return out;
+}
+
+std::string Metrics::renderJson(const std::vector<MetricValue>& extra) const {
+    std::string out = "{";
+    for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+        out += "\"" + camelCase(COUNTER_NAMES[i]) + "\": " +
+               std::to_string(getCounter(static_cast<Counter>(i))) + ", ";
+    }
+    out += "\"connectionsActive\": " +
+           std::to_string(activeConnections());
+    for (const auto& value : extra) {
+        out += ", \"" + camelCase(value.name) + "\": " + formatDouble(value.value);
+    }
+
+    out += ", \"firstByte\": ";
+    appendHistogramJson(out, mergeFirstByte());
+
+    out += ", \"requests\": [";
+    bool first = true;
+    for (size_t route = 0; route < routes.size(); ++route) {
+        for (size_t statusClass = 0; statusClass < STATUS_CLASSES; ++statusClass) {
+            LatencyHistogram::Snapshot snapshot = mergeRequests(route, statusClass);
+            if (snapshot.count == 0) {
+                continue;
+            }
+            out += first ? "" : ", ";
+            first = false;
+            out += "{\"route\": \"" + escapeLabel(routes[route]) + "\", \"status\": \"" +
+                   statusClassLabel(statusClass) + "\", \"duration\": ";
+            appendHistogramJson(out, snapshot);
+            out += "}";
+        }
+    }
+    out += "]}";
+    return out;
+}
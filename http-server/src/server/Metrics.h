@@ -0,0 +1,105 @@
+// src/server/Metrics.h
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Latency histogram with HDR-style log-linear buckets: exact below 16us,
+// then 16 buckets per power of two, so any recorded value is reported
+// within about 6%. Values are microseconds, clamped at 2^32 (~71 min).
+// Recording is a few relaxed atomic adds.
+class LatencyHistogram {
+public:
+    static constexpr size_t SUB_BUCKET_BITS = 4;
+    static constexpr size_t SUB_BUCKETS = size_t(1) << SUB_BUCKET_BITS;
+    static constexpr size_t BUCKET_COUNT = (32 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    // Histogram merged over shards, read by the exporters
+    struct Snapshot {
+        std::array<uint64_t, BUCKET_COUNT> counts{};
+        uint64_t count = 0;
+        uint64_t sum = 0;
+        uint64_t max = 0;
+
+        uint64_t countAtOrBelow(uint64_t micros) const;
+        uint64_t percentile(double fraction) const;
+    };
+
+    LatencyHistogram();
+
+    void record(uint64_t micros);
+    void addTo(Snapshot& snapshot) const;
+
+    static size_t bucketFor(uint64_t micros);
+    static uint64_t bucketUpperBound(size_t bucket);     // Largest value counted in the bucket
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> counts;
+    std::atomic<uint64_t> sum;
+    std::atomic<uint64_t> max;
+};
+
+// A value computed by the server at scrape time, exported next to the
+// registry's own metrics
+struct MetricValue {
+    std::string name;
+    std::string help;
+    bool counter;       // Otherwise a gauge
+    double value;
+};
+
+// Server-wide metrics. Counters and histograms are sharded by the CPU the
+// recording thread runs on, so threads on different cores never write the
+// same cache line; readers sum the shards. Routes are registered before
+// the server starts taking requests.
+class Metrics {
+public:
+    enum Counter {
+        CONNECTIONS_OPENED,
+        CONNECTIONS_CLOSED,
+        BYTES_RECEIVED,
+        BYTES_SENT,
+        COUNTER_COUNT
+    };
+
+    static constexpr size_t STATUS_CLASSES = 5;     // 1xx .. 5xx
+
+    explicit Metrics(size_t shardCount = 0);
+
+    Metrics(const Metrics&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+
+    // Not thread-safe; call before any request is recorded
+    size_t addRoute(const std::string& name);
+
+    void add(Counter counter, uint64_t amount = 1);
+    void recordRequest(size_t route, int status, uint64_t micros);
+    void recordFirstByte(uint64_t micros);
+
+    uint64_t getCounter(Counter counter) const;
+    uint64_t activeConnections() const;
+
+    // Prometheus text exposition format, version 0.0.4
+    std::string renderPrometheus(const std::vector<MetricValue>& extra) const;
+    std::string renderJson(const std::vector<MetricValue>& extra) const;
+
+private:
+    struct alignas(64) Shard {
+        std::array<std::atomic<uint64_t>, COUNTER_COUNT> counters;
+        LatencyHistogram firstByte;
+        std::vector<std::unique_ptr<LatencyHistogram>> requests;    // route * STATUS_CLASSES + class
+
+        Shard();
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::vector<std::string> routes;
+
+    Shard& localShard();
+    LatencyHistogram::Snapshot mergeFirstByte() const;
+    LatencyHistogram::Snapshot mergeRequests(size_t route, size_t statusClass) const;
+};
@@ -0,0 +1,2021 @@
+// src/server/Server.cpp
+#include "Server.h"
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/sendfile.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+
+namespace {
+
+// What a ring completion belongs to: the operation in the top byte, the
+// connection id below it
+enum RingOp : uint64_t {
+    RING_ACCEPT = 1,
+    RING_RECEIVE,
+    RING_SEND,
+    RING_SPLICE_IN,
+    RING_SPLICE_OUT,
+    RING_CLOSE,
+    RING_CANCEL,
+    RING_WAKEUP,
+    RING_TICK,
+};
+
+constexpr int RING_OP_SHIFT = 56;
+constexpr uint64_t RING_ID_MASK = (uint64_t(1) << RING_OP_SHIFT) - 1;
+
+uint64_t ringTag(RingOp op, uint64_t id = 0) {
+    return (static_cast<uint64_t>(op) << RING_OP_SHIFT) | id;
+}
+
+} // namespace
+
+bool HttpServer::initialize(const std::string& configPath) {
+    Config serverConfig;
+    if (!configPath.empty()) {
+        if (!serverConfig.loadFromFile(configPath)) {
+            Logger::error("Failed to load config file: " + configPath);
+            return false;
+        }
+    } else {
+        serverConfig = Config::getDefault();
+    }
+    return initialize(serverConfig);
+}
+
+bool HttpServer::initialize(const Config& serverConfig) {
+    try {
+        config = serverConfig;
+
+        // Get configuration values
+        int port = config.getInt("server.port", 8080);
+        int maxThreads = config.getInt("server.max_threads", 4);
+        webRoot = config.getString("server.web_root", "./www");
+        keepAliveTimeout = std::chrono::seconds(config.getInt("server.keep_alive_timeout", 5));
+        writeTimeout = std::chrono::seconds(std::max(1, config.getInt("server.write_timeout", 30)));
+        keepAliveValue = "timeout=" + std::to_string(keepAliveTimeout.count());
+        compressionEnabled = config.getBool("compression.enabled", true);
+
+        cacheControlRules = config.getSection("cache_control");
+        std::sort(cacheControlRules.begin(), cacheControlRules.end(),
+                  [](const auto& a, const auto& b) { return a.first.size() > b.first.size(); });
+        // Extra MIME types, e.g. "mime_types.glb = model/gltf-binary"
+        MimeTypes::clearOverrides();
+        for (const auto& mapping : config.getSection("mime_types")) {
+            MimeTypes::add(mapping.first, mapping.second);
+        }
+
+        compressionLevel = config.getInt("compression.level", 6);
+        compressionMinSize = static_cast<size_t>(config.getInt("compression.min_size", 256));
+        maxKeepAliveRequests = std::max(1, config.getInt("server.max_keep_alive_requests", 100));
+        maxBodySize = static_cast<size_t>(std::max(0, config.getInt("security.max_file_size", 10485760)));
+
+        if (!createReactors(port)) {
+            return false;
+        }
+
+        // Static file cache, kept coherent through inotify on the web root
+        if (config.getBool("cache.enabled", true)) {
+            fileCache = std::make_unique<FileCache>(
+                static_cast<size_t>(config.getInt("cache.max_size", 64 * 1024 * 1024)),
+                static_cast<size_t>(config.getInt("cache.max_file_size", 1024 * 1024)));
+        }
+
+        // Sharded reactors answer requests on the core that accepted them;
+        // a single reactor hands them to the worker pool
+        if (reactors.size() == 1) {
+            threadPool = std::make_unique<ThreadPool>(maxThreads);
+        }
+
+        // Create web root directory if it doesn't exist
+        if (!FileHandler::isDirectory(webRoot)) {
+            // Try to create directory
+            #ifdef _WIN32
+                _mkdir(webRoot.c_str());
+            #else
+                mkdir(webRoot.c_str(), 0755);
+            #endif
+            Logger::info("Created web root directory: " + webRoot);
+        }
+
+        if (fileCache && !fileCache->watch(webRoot)) {
+            Logger::warning("inotify unavailable, static file cache disabled");
+            fileCache.reset();
+        }
+
+        malformedRoute = metrics.addRoute("malformed");
+        unmatchedRoute = metrics.addRoute("unmatched");
+        registerRoutes();
+
+        if (config.getBool("access_log.enabled", false)) {
+            accessLog = std::make_unique<AccessLog>(
+                config.getString("access_log.file", "access.log.bin"),
+                static_cast<size_t>(config.getInt("access_log.max_size", 64 * 1024 * 1024)),
+                static_cast<size_t>(config.getInt("access_log.max_files", 5)));
+            if (!accessLog->start()) {
+                Logger::warning("Access log disabled");
+                accessLog.reset();
+            }
+        }
+
+        Logger::info("Server initialized successfully");
+        Logger::info("Port: " + std::to_string(port));
+        Logger::info("Web root: " + webRoot);
+        if (threadPool) {
+            Logger::info("Threads: " + std::to_string(maxThreads));
+        } else {
+            Logger::info("Reactors: " + std::to_string(reactors.size()) + " (SO_REUSEPORT, requests handled inline)");
+        }
+        Logger::info("Request scanner: " + std::string(Scanner::getImplementation()));
+        Logger::info("I/O backend: " + std::string(reactors.front()->ring ? "io_uring" : "epoll"));
+
+        return true;
+
+    } catch (const std::exception& e) {
+        Logger::error("Initialization error: " + std::string(e.what()));
+        return false;
+    }
+}
+
+bool HttpServer::createReactors(int port) {
+    size_t count = 1;
+    bool reusePort = config.getBool("server.reuse_port", false);
+    if (reusePort) {
+        int configured = config.getInt("server.reactors", 0);
+        count = configured > 0 ? static_cast<size_t>(configured)
+                               : std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Pin reactors to the CPUs this process may run on, in order
+    std::vector<int> cpus;
+    if (reusePort && config.getBool("server.cpu_affinity", true)) {
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &allowed)) {
+                    cpus.push_back(cpu);
+                }
+            }
+        }
+    }
+
+    std::string backend = config.getString("server.io_backend", "epoll");
+    bool useRing = backend == "io_uring";
+    if (!useRing && backend != "epoll") {
+        Logger::warning("Unknown server.io_backend '" + backend + "', using epoll");
+    }
+
+    reactors.clear();
+    for (size_t i = 0; i < count; ++i) {
+        auto reactor = std::make_unique<Reactor>();
+        reactor->index = i;
+        reactor->cpu = cpus.empty() ? -1 : cpus[i % cpus.size()];
+        if (!openListener(*reactor, port, reusePort)) {
+            return false;
+        }
+
+        if (!reactor->loop.create()) {
+            Logger::error("Failed to create event loop");
+            return false;
+        }
+        reactor->readBuffer.resize(64 * 1024);
+
+        // If the kernel refuses one reactor a ring, the rest stay on epoll
+        if (useRing && !createRing(*reactor)) {
+            useRing = false;
+        }
+        reactors.push_back(std::move(reactor));
+    }
+    return true;
+}
+
+bool HttpServer::openListener(Reactor& reactor, int port, bool reusePort) {
+    reactor.listener = std::make_unique<Socket>();
+    if (!reactor.listener->create()) {
+        Logger::error("Failed to create socket");
+        return false;
+    }
+
+    if (reusePort && !reactor.listener->setReusePort()) {
+        Logger::error("SO_REUSEPORT is not supported on this system");
+        return false;
+    }
+
+    if (!reactor.listener->bind(port)) {
+        Logger::error("Failed to bind to port " + std::to_string(port));
+        return false;
+    }
+
+    if (!reactor.listener->listen(SOMAXCONN)) {
+        Logger::error("Failed to listen on socket");
+        return false;
+    }
+
+    // The event loop owns every socket in non-blocking mode
+    if (!reactor.listener->setNonBlocking()) {
+        Logger::error("Failed to make listening socket non-blocking");
+        return false;
+    }
+    return true;
+}
+
+void HttpServer::start() {
+    if (reactors.empty()) {
+        Logger::error("Server not initialized");
+        return;
+    }
+
+    // Routes are fixed from here on, so workers match without locking
+    router.freeze();
+
+#ifdef HTTPSERVER_COROUTINES
+    // Inline reactors have no workers for coroutine routes to offload to
+    if (!threadPool && !asyncRoutes.empty()) {
+        offloadPool = std::make_unique<ThreadPool>(config.getInt("server.max_threads", 4));
+    }
+#endif
+
+    for (const auto& reactor : reactors) {
+        if (!reactor->ring && !reactor->loop.add(reactor->listener->getFD(), EPOLLIN | EPOLLET)) {
+            Logger::error("Failed to register listening socket");
+            return;
+        }
+    }
+
+    running = true;
+    Logger::info("Server started. Listening for connections...");
+
+    if (reactors.size() == 1) {
+        runReactor(*reactors.front());
+        return;
+    }
+
+    for (const auto& reactor : reactors) {
+        Reactor* shard = reactor.get();
+        shard->thread = std::thread([this, shard]() { runReactor(*shard); });
+    }
+    for (const auto& reactor : reactors) {
+        reactor->thread.join();
+    }
+}
+
+void HttpServer::runReactor(Reactor& reactor) {
+    reactor.loop.makeCurrent();
+    if (reactor.cpu >= 0) {
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        CPU_SET(reactor.cpu, &mask);
+        if (sched_setaffinity(0, sizeof(mask), &mask) != 0) {
+            Logger::warning("Failed to pin reactor " + std::to_string(reactor.index) +
+                            " to CPU " + std::to_string(reactor.cpu));
+        }
+    }
+
+    if (reactor.ring) {
+        runRingReactor(reactor);
+        return;
+    }
+
+    EventLoop& loop = reactor.loop;
+    int listenFd = reactor.listener->getFD();
+    std::vector<epoll_event> events(1024);
+    auto lastIdleSweep = std::chrono::steady_clock::now();
+    while (running) {
+        int ready = loop.wait(events, loop.hasDeferred() ? 0 : 1000);
+        if (ready < 0) {
+            Logger::error("Event loop wait failed: " + std::string(strerror(errno)));
+            break;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastIdleSweep >= std::chrono::seconds(1)) {
+            closeIdleConnections(reactor);
+            lastIdleSweep = now;
+        }
+
+        for (int i = 0; i < ready; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == listenFd) {
+                acceptConnections(reactor);
+            } else if (fd == loop.getWakeupFD()) {
+                loop.runPending();
+            } else {
+                handleConnectionEvent(reactor, fd, events[i].events);
+            }
+        }
+        loop.runDeferred();
+    }
+
+    closeAllConnections(reactor);
+}
+
+void HttpServer::stop() {
+    running = false;
+    for (const auto& reactor : reactors) {
+        reactor->loop.wakeup();
+        if (reactor->listener) {
+            reactor->listener->close();
+        }
+    }
+    Logger::info("Server stopped");
+}
+
+void HttpServer::acceptConnections(Reactor& reactor) {
+    // Edge-triggered: drain the accept queue completely
+    while (running) {
+        std::string clientIP;
+        int clientSocket = reactor.listener->accept(clientIP);
+
+        if (clientSocket < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK && running) {
+                Logger::error("Failed to accept connection: " + std::string(strerror(errno)));
+            }
+            return;
+        }
+
+        if (!Socket::setNonBlocking(clientSocket) ||
+            !reactor.loop.add(clientSocket, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET)) {
+            Logger::error("Failed to register connection from: " + clientIP);
+            closesocket(clientSocket);
+            continue;
+        }
+
+        Logger::debug([&] { return "New connection from: " + clientIP; });
+        auto conn = std::make_shared<Connection>(&reactor, clientSocket, clientIP);
+        conn->parser.setLimits(MAX_HEADER_SIZE, MAX_HEADER_COUNT, maxBodySize);
+        reactor.connections[clientSocket] = conn;
+        metrics.add(Metrics::CONNECTIONS_OPENED);
+    }
+}
+
+void HttpServer::handleConnectionEvent(Reactor& reactor, int fd, uint32_t events) {
+    auto it = reactor.connections.find(fd);
+    if (it == reactor.connections.end()) {
+        return;
+    }
+    std::shared_ptr<Connection> conn = it->second;
+
+    if (events & EPOLLERR) {
+        closeConnection(conn);
+        return;
+    }
+
+    if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) {
+        readFromConnection(conn);
+    }
+
+    if (!conn->closed && (events & EPOLLOUT)) {
+        flushConnection(conn);
+    }
+}
+
+void HttpServer::readFromConnection(const std::shared_ptr<Connection>& conn) {
+    std::vector<char>& readBuffer = conn->reactor->readBuffer;
+    while (true) {
+        if (isInputFull(*conn)) {
+            // Left in the socket; resumeInput reads it once there is room
+            conn->readPaused = true;
+            break;
+        }
+        ssize_t bytesReceived = recv(conn->fd, readBuffer.data(), readBuffer.size(), 0);
+
+        if (bytesReceived > 0) {
+            metrics.add(Metrics::BYTES_RECEIVED, static_cast<uint64_t>(bytesReceived));
+            conn->inBuffer.append(readBuffer.data(), bytesReceived);
+            conn->lastActivity = std::chrono::steady_clock::now();
+            continue;
+        }
+
+        if (bytesReceived == 0) {
+            Logger::debug([&] { return "Client disconnected: " + conn->clientIP; });
+            conn->peerClosed = true;
+            break;
+        }
+
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+
+        Logger::error("Error receiving data from: " + conn->clientIP);
+        closeConnection(conn);
+        return;
+    }
+
+    onInputReceived(conn);
+}
+
+void HttpServer::onInputReceived(const std::shared_ptr<Connection>& conn) {
+    dispatchRequest(conn);
+    resumeInput(conn);
+
+    // Nothing in flight for a client that went away
+    if (conn->peerClosed && !conn->processing && !conn->hasPendingOutput()) {
+        closeConnection(conn);
+    }
+}
+
+bool HttpServer::isInputFull(const Connection& conn) const {
+    // An idle connection may buffer one whole request of the largest size
+    // the parser accepts (header, body and trailer section), which it
+    // either completes or rejects
+    if (conn.processing || conn.hasPendingOutput()) {
+        return conn.inBuffer.size() >= INPUT_READ_AHEAD;
+    }
+    return conn.inBuffer.size() > 2 * MAX_HEADER_SIZE + maxBodySize;
+}
+
+void HttpServer::resumeInput(const std::shared_ptr<Connection>& conn) {
+    if (!conn->readPaused || conn->closed || isInputFull(*conn)) {
+        return;
+    }
+    conn->readPaused = false;
+
+    if (!conn->reactor->ring) {
+        // Edge-triggered: nothing more is reported until the socket is drained
+        readFromConnection(conn);
+    } else if (!conn->ring.receiving) {
+        // Otherwise the cancelled receive is re-armed when its last completion arrives
+        conn->reactor->ring->receive(conn->fd, ringTag(RING_RECEIVE, conn->ring.id));
+        conn->ring.receiving = true;
+    }
+}
+
+bool HttpServer::findCompleteRequest(Connection& conn, size_t& requestLength) {
+    RequestParser::Status status = conn.parser.parse(conn.inBuffer.data() + conn.requestStart,
+                                                     conn.inBuffer.size() - conn.requestStart);
+    if (status != RequestParser::Status::COMPLETE) {
+        return false;
+    }
+    requestLength = conn.parser.getMessageLength();
+    return true;
+}
+
+void HttpServer::dispatchRequest(const std::shared_ptr<Connection>& conn) {
+    if (conn->closed || conn->processing || conn->closeAfterWrite) {
+        return;
+    }
+
+    // Carve every complete request out of the buffer so pipelined requests
+    // from a single read are handled as one batch
+    std::vector<HttpRequest> batch;
+    size_t remaining = maxKeepAliveRequests - conn->requestsServed;
+    size_t requestLength = 0;
+    while (batch.size() < std::min(remaining, MAX_PIPELINE_DEPTH) &&
+           findCompleteRequest(*conn, requestLength)) {
+        // A request that fills the whole buffer, typically a large upload,
+        // takes the buffer over instead of copying it
+        std::string raw;
+        if (conn->requestStart == 0 && requestLength == conn->inBuffer.size()) {
+            raw.swap(conn->inBuffer);
+            requestLength = 0;
+        } else {
+            raw = conn->inBuffer.substr(conn->requestStart, requestLength);
+        }
+        batch.emplace_back();
+        batch.back().assign(std::move(raw), std::move(conn->parser.getLayout()));
+        conn->nextRequest(requestLength);
+    }
+    conn->compactInput();
+
+    if (batch.empty()) {
+        // The client waits for an interim response before sending the body
+        if (conn->parser.isAwaitingBody() && conn->parser.expectsContinue() && !conn->continueSent) {
+            conn->continueSent = true;
+            conn->outQueue.emplace_back(std::string("HTTP/1.1 100 Continue\r\n\r\n"));
+            flushConnection(conn);
+            return;
+        }
+
+        // A malformed request is answered once everything before it has been
+        // written, and the connection is closed since framing is lost
+        if (conn->parser.getErrorStatus() != 0 && !conn->hasPendingOutput()) {
+            int status = conn->parser.getErrorStatus();
+            HttpResponse response =
+                HttpResponse::makeErrorResponse(status, std::string(HttpResponse::getStatusMessage(status)));
+            response.setHeader("Connection", "close");
+            conn->outQueue.emplace_back(response.toString());
+            recordRequest(*conn, nullptr, malformedRoute, status, response.getBodyLength(),
+                          std::chrono::steady_clock::now());
+            conn->closeAfterWrite = true;
+            conn->discardInput();
+            flushConnection(conn);
+        }
+        return;
+    }
+    conn->processing = true;
+
+    // Only complete requests reach the pool; the responses are handed back
+    // to the loop, which owns the socket
+    auto work = std::make_shared<WorkBatch>();
+    work->requests = std::move(batch);
+    work->served = conn->requestsServed;
+    work->received = std::chrono::steady_clock::now();
+    schedule(conn, std::move(work));
+}
+
+void HttpServer::schedule(const std::shared_ptr<Connection>& conn, std::shared_ptr<WorkBatch> work) {
+    if (threadPool) {
+        threadPool->enqueue([this, conn, work]() { processBatch(conn, work); });
+    } else {
+        processBatch(conn, std::move(work));
+    }
+}
+
+void HttpServer::processBatch(const std::shared_ptr<Connection>& conn, std::shared_ptr<WorkBatch> work) {
+    OutputBuilder output;
+    size_t responseCount = 0;
+    bool keepAlive = work->keepAlive;
+
+    // A response being streamed goes out before any request behind it
+    if (work->producer) {
+        if (!streamBody(*work, output)) {
+            postResponses(conn, responseCount, output, true, work);
+            return;
+        }
+        recordRequest(*conn, &work->requests[work->next - 1], work->streamRoute, work->streamStatus,
+                      work->streamedBytes, work->received);
+        keepAlive = work->keepAlive;
+        responseCount++;
+    }
+
+    while (work->next < work->requests.size() && keepAlive) {
+        // Everything the response allocates lives in the worker's arena and
+        // is released when this iteration ends
+        ArenaScope arena;
+        const HttpRequest& request = work->requests[work->next++];
+        bool requestKeepAlive = false;
+        size_t route = unmatchedRoute;
+        HttpResponse response = processRequest(request, requestKeepAlive, route, *work);
+#ifdef HTTPSERVER_COROUTINES
+        if (work->asyncRoute && !work->asyncResponse) {
+            // The coroutine starts on the loop once the responses ahead of
+            // it are queued, and the batch resumes from this request
+            work->next--;
+            postResponses(conn, responseCount, output, true, work);
+            return;
+        }
+#endif
+
+        // The last request allowed on this connection is answered with close
+        keepAlive = requestKeepAlive && work->served + work->next < maxKeepAliveRequests && running;
+
+        // Streamed bodies are chunked for HTTP/1.1; an HTTP/1.0 client can
+        // only be told where the body ends by closing the connection. HEAD
+        // advertises the framing GET would use, but has no body to end.
+        bool streaming = response.isStreaming();
+        bool chunked = (streaming || response.wasStreaming()) && request.getVersion() == "HTTP/1.1";
+        if (chunked) {
+            response.setHeader("Transfer-Encoding", "chunked");
+        } else if (streaming) {
+            keepAlive = false;
+        }
+
+        if (keepAlive) {
+            response.setHeader("Connection", "keep-alive");
+            response.setHeader("Keep-Alive", keepAliveValue);
+        } else {
+            response.setHeader("Connection", "close");
+        }
+
+        output.addHead(response);
+        if (streaming) {
+            work->producer = response.takeBodyProducer();
+            work->chunked = chunked;
+            work->keepAlive = keepAlive;
+            work->streamRoute = route;
+            work->streamStatus = response.getStatusCode();
+            work->streamedBytes = 0;
+            if (!streamBody(*work, output)) {
+                postResponses(conn, responseCount, output, true, work);
+                return;
+            }
+            recordRequest(*conn, &request, route, work->streamStatus, work->streamedBytes, work->received);
+            keepAlive = work->keepAlive;
+        } else {
+            recordRequest(*conn, &request, route, response.getStatusCode(), response.getBodyLength(), work->received);
+            output.addBody(response);
+        }
+        responseCount++;
+    }
+
+    postResponses(conn, responseCount, output, keepAlive, nullptr);
+}
+
+bool HttpServer::streamBody(WorkBatch& work, OutputBuilder& output) {
+    // Produce at most one step's worth; the rest waits for the client to
+    // read what has been queued
+    size_t produced = 0;
+    bool more = true;
+    try {
+        std::string piece;
+        while (more && produced < STREAM_STEP_SIZE) {
+            piece.clear();
+            more = work.producer(piece);
+            if (piece.empty()) {
+                continue;
+            }
+            produced += piece.size();
+            work.streamedBytes += piece.size();
+
+            // The chunk framing goes around the piece rather than being
+            // copied together with it
+            if (work.chunked) {
+                char sizeLine[24];
+                int sizeLength = snprintf(sizeLine, sizeof(sizeLine), "%zx\r\n", piece.size());
+                output.addData(std::string(sizeLine, sizeLength));
+                output.addData(std::move(piece));
+                output.addData("\r\n");
+            } else {
+                output.addData(std::move(piece));
+            }
+            piece = std::string();
+        }
+    } catch (const std::exception& e) {
+        // The headers are already out. Closing without the last chunk tells
+        // the client the body is incomplete.
+        Logger::error("Error streaming response: " + std::string(e.what()));
+        work.producer = nullptr;
+        work.keepAlive = false;
+        return true;
+    }
+
+    if (more) {
+        return false;
+    }
+    if (work.chunked) {
+        output.addData("0\r\n\r\n");
+    }
+    work.producer = nullptr;
+    return true;
+}
+
+void HttpServer::recordRequest(const Connection& conn, const HttpRequest* request, size_t route, int status,
+                               uint64_t bytes, std::chrono::steady_clock::time_point received) {
+    auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - received);
+    uint64_t latencyMicros = static_cast<uint64_t>(std::max<int64_t>(latency.count(), 0));
+    metrics.recordRequest(route, status, latencyMicros);
+
+    if (!accessLog) {
+        return;
+    }
+
+    AccessLogEntry entry;
+    entry.timeMicros = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    entry.latencyMicros = static_cast<uint32_t>(std::min<uint64_t>(latencyMicros, UINT32_MAX));
+    entry.bytes = bytes;
+    entry.status = static_cast<uint16_t>(status);
+    entry.clientIP = conn.clientIP;
+    if (request) {
+        entry.method = request->getMethodName();
+        entry.path = request->getPath();
+        entry.version = request->getVersion();
+        entry.referer = request->getHeader(HeaderId::REFERER);
+        entry.userAgent = request->getHeader(HeaderId::USER_AGENT);
+    }
+    accessLog->record(entry);
+}
+
+void HttpServer::postResponses(const std::shared_ptr<Connection>& conn, size_t responseCount,
+                               OutputBuilder& builder, bool keepAlive,
+                               std::shared_ptr<WorkBatch> unfinished) {
+    std::vector<OutputChunk> output = builder.finish();
+    auto deliver = [this, conn, responseCount, keepAlive, output = std::move(output),
+                    unfinished = std::move(unfinished)]() mutable {
+        onResponseReady(conn, responseCount, std::move(output), keepAlive, std::move(unfinished));
+    };
+
+    // Inline batches already run on the loop thread; they only need to wait
+    // until the caller has unwound
+    if (threadPool) {
+        conn->reactor->loop.post(std::move(deliver));
+    } else {
+        conn->reactor->loop.defer(std::move(deliver));
+    }
+}
+
+void HttpServer::resumeStream(const std::shared_ptr<Connection>& conn) {
+    if (!conn->pendingWork || conn->closed || conn->queuedBytes() > STREAM_LOW_WATER) {
+        return;
+    }
+    std::shared_ptr<WorkBatch> work = std::move(conn->pendingWork);
+    conn->pendingWork.reset();
+    schedule(conn, std::move(work));
+}
+
+void HttpServer::onResponseReady(const std::shared_ptr<Connection>& conn, size_t responseCount,
+                                 std::vector<OutputChunk> output, bool keepAlive,
+                                 std::shared_ptr<WorkBatch> unfinished) {
+    if (conn->closed) {
+        return;
+    }
+
+    // A batch stopped mid-stream keeps the connection busy until it finishes.
+    // One stopped at a coroutine route is owned by that coroutine instead,
+    // which reschedules it once the handler returns.
+    conn->processing = unfinished != nullptr;
+#ifdef HTTPSERVER_COROUTINES
+    bool awaitingRoute = unfinished && unfinished->asyncRoute && !unfinished->asyncResponse;
+#else
+    bool awaitingRoute = false;
+#endif
+    if (!awaitingRoute) {
+        conn->pendingWork = std::move(unfinished);
+    }
+    conn->requestsServed += responseCount;
+    conn->lastActivity = std::chrono::steady_clock::now();
+    for (auto& chunk : output) {
+        conn->outQueue.push_back(std::move(chunk));
+    }
+
+    if (!keepAlive) {
+        // Anything pipelined after a closing response is discarded
+        conn->closeAfterWrite = true;
+        conn->discardInput();
+    }
+    flushConnection(conn);
+
+#ifdef HTTPSERVER_COROUTINES
+    // Started after the responses ahead of it are on their way
+    if (awaitingRoute && !conn->closed) {
+        runAsyncRoute(conn, std::move(unfinished));
+    }
+#endif
+}
+
+void HttpServer::flushConnection(const std::shared_ptr<Connection>& conn) {
+    while (conn->hasPendingOutput()) {
+        if (conn->reactor->ring) {
+            // One write in flight at a time; its completion comes back here
+            submitWrite(conn);
+            resumeStream(conn);
+            return;
+        }
+
+        bool progressed = conn->outQueue.front().isFile() ? writeFile(conn) : writeData(conn);
+        if (!progressed) {
+            // Closed on error, or resumed on the next EPOLLOUT edge. A stream
+            // can keep producing while the socket still has enough queued.
+            resumeStream(conn);
+            return;
+        }
+    }
+
+    if (conn->closeAfterWrite) {
+        closeConnection(conn);
+        return;
+    }
+
+    if (!conn->processing) {
+        // The next request on a persistent connection may already be buffered
+        dispatchRequest(conn);
+        if (conn->peerClosed && !conn->processing) {
+            closeConnection(conn);
+            return;
+        }
+        resumeInput(conn);
+    } else {
+        resumeStream(conn);
+    }
+}
+
+bool HttpServer::writeData(const std::shared_ptr<Connection>& conn) {
+    // Gather the run of queued data chunks into a single vectored write
+    std::vector<iovec> iov;
+    size_t offset = conn->outOffset;
+    bool moreFollows = false;
+    for (const auto& chunk : conn->outQueue) {
+        if (chunk.isFile()) {
+            moreFollows = true;
+            break;
+        }
+        if (iov.size() == MAX_IOVECS) {
+            break;
+        }
+        iovec entry;
+        entry.iov_base = const_cast<char*>(chunk.bytes()) + offset;
+        entry.iov_len = chunk.size() - offset;
+        iov.push_back(entry);
+        offset = 0;
+    }
+
+    // sendmsg is writev with flags, so a vanished peer can't raise SIGPIPE.
+    // MSG_MORE lets the headers share a segment with the file that follows.
+    msghdr message{};
+    message.msg_iov = iov.data();
+    message.msg_iovlen = iov.size();
+    ssize_t bytesSent = sendmsg(conn->fd, &message, MSG_NOSIGNAL | (moreFollows ? MSG_MORE : 0));
+    if (bytesSent < 0) {
+        if (errno == EINTR) {
+            return true;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            Logger::error("Failed to send response");
+            closeConnection(conn);
+        }
+        return false;
+    }
+
+    onDataSent(*conn, static_cast<size_t>(bytesSent));
+    return true;
+}
+
+void HttpServer::onDataSent(Connection& conn, size_t bytesSent) {
+    metrics.add(Metrics::BYTES_SENT, static_cast<uint64_t>(bytesSent));
+    if (bytesSent > 0) {
+        conn.lastActivity = std::chrono::steady_clock::now();
+    }
+    if (!conn.firstByteSent && bytesSent > 0) {
+        conn.firstByteSent = true;
+        auto elapsed = std::chrono::steady_clock::now() - conn.acceptedAt;
+        metrics.recordFirstByte(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+    }
+
+    // Pop fully written chunks, remember how far into the next we got
+    size_t written = bytesSent;
+    while (written > 0) {
+        size_t left = conn.outQueue.front().size() - conn.outOffset;
+        if (written < left) {
+            conn.outOffset += written;
+            break;
+        }
+        written -= left;
+        conn.outQueue.pop_front();
+        conn.outOffset = 0;
+    }
+}
+
+bool HttpServer::writeFile(const std::shared_ptr<Connection>& conn) {
+    OutputChunk& chunk = conn->outQueue.front();
+    while (chunk.fileRemaining > 0) {
+        // sendfile advances fileOffset itself on partial writes
+        ssize_t bytesSent = sendfile(conn->fd, chunk.file->getFD(), &chunk.fileOffset,
+                                     std::min(chunk.fileRemaining, MAX_SENDFILE_CHUNK));
+        if (bytesSent > 0) {
+            chunk.fileRemaining -= static_cast<size_t>(bytesSent);
+            metrics.add(Metrics::BYTES_SENT, static_cast<uint64_t>(bytesSent));
+            conn->lastActivity = std::chrono::steady_clock::now();
+            continue;
+        }
+        if (bytesSent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytesSent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return false;
+        }
+
+        // A zero return means the file shrank underneath us
+        Logger::error("Failed to send file");
+        closeConnection(conn);
+        return false;
+    }
+
+    conn->outQueue.pop_front();
+    return true;
+}
+
+void HttpServer::closeConnection(const std::shared_ptr<Connection>& conn) {
+    if (conn->closed) {
+        return;
+    }
+    conn->closed = true;
+    conn->pendingWork.reset();
+    Reactor& reactor = *conn->reactor;
+    if (reactor.ring) {
+        // The ring holds its own reference to the socket, so operations still
+        // armed on it are cancelled; the close is queued behind the cancels
+        Connection::RingState& state = conn->ring;
+        if (state.receiving) {
+            reactor.ring->cancel(ringTag(RING_RECEIVE, state.id), ringTag(RING_CANCEL));
+        }
+        if (state.writes > 0) {
+            reactor.ring->cancel(ringTag(RING_SEND, state.id), ringTag(RING_CANCEL));
+            reactor.ring->cancel(ringTag(RING_SPLICE_OUT, state.id), ringTag(RING_CANCEL));
+        }
+        reactor.ring->close(conn->fd, ringTag(RING_CLOSE, state.id));
+        state.closing = true;
+    } else {
+        reactor.loop.remove(conn->fd);
+        closesocket(conn->fd);
+    }
+    reactor.connections.erase(conn->fd);
+    metrics.add(Metrics::CONNECTIONS_CLOSED);
+}
+
+void HttpServer::closeIdleConnections(Reactor& reactor) {
+    auto now = std::chrono::steady_clock::now();
+    auto idleDeadline = now - keepAliveTimeout;
+    auto stallDeadline = now - writeTimeout;
+
+    std::vector<std::shared_ptr<Connection>> idle;
+    for (const auto& entry : reactor.connections) {
+        const auto& conn = entry.second;
+        if (conn->hasPendingOutput()) {
+            // A client that stops reading would otherwise pin the fd, the
+            // queued output and any file behind it for good
+            if (conn->lastActivity < stallDeadline) {
+                idle.push_back(conn);
+            }
+        } else if (!conn->processing && conn->lastActivity < idleDeadline) {
+            idle.push_back(conn);
+        }
+    }
+
+    for (const auto& conn : idle) {
+        Logger::debug([&] {
+            return std::string(conn->hasPendingOutput() ? "Closing stalled connection: " : "Closing idle connection: ") +
+                   conn->clientIP;
+        });
+        closeConnection(conn);
+    }
+}
+
+void HttpServer::closeAllConnections(Reactor& reactor) {
+    while (!reactor.connections.empty()) {
+        std::shared_ptr<Connection> conn = reactor.connections.begin()->second;
+        closeConnection(conn);
+    }
+}
+
+bool HttpServer::createRing(Reactor& reactor) {
+    auto ring = std::make_unique<IoUring>();
+    std::string error;
+    if (!ring->create(RING_ENTRIES, RING_BUFFER_COUNT, RING_BUFFER_SIZE, error)) {
+        Logger::warning("io_uring unavailable (" + error + "), falling back to epoll");
+        return false;
+    }
+    reactor.ring = std::move(ring);
+    return true;
+}
+
+void HttpServer::runRingReactor(Reactor& reactor) {
+    IoUring& ring = *reactor.ring;
+    EventLoop& loop = reactor.loop;
+    ring.accept(reactor.listener->getFD(), ringTag(RING_ACCEPT));
+    ring.pollReadable(loop.getWakeupFD(), ringTag(RING_WAKEUP));
+    ring.timeout(1000, ringTag(RING_TICK));
+
+    RingCompletion completion;
+    while (running) {
+        // Everything queued since the last pass reaches the kernel in this
+        // one call, which then waits for the next completion
+        if (!ring.submit(loop.hasDeferred() ? 0 : 1)) {
+            Logger::error("io_uring submit failed: " + std::string(strerror(errno)));
+            break;
+        }
+        while (ring.nextCompletion(completion)) {
+            handleCompletion(reactor, completion);
+        }
+        loop.runDeferred();
+    }
+
+    // Give the cancels and closes a moment to complete, so no connection is
+    // freed while the kernel may still be using its buffers
+    closeAllConnections(reactor);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (!reactor.ringConnections.empty() && std::chrono::steady_clock::now() < deadline) {
+        if (!ring.submit(1)) {
+            break;
+        }
+        while (ring.nextCompletion(completion)) {
+            handleCompletion(reactor, completion);
+        }
+    }
+}
+
+void HttpServer::handleCompletion(Reactor& reactor, const RingCompletion& completion) {
+    IoUring& ring = *reactor.ring;
+    uint64_t op = completion.userData >> RING_OP_SHIFT;
+    switch (op) {
+    case RING_ACCEPT:
+        acceptRingConnection(reactor, completion);
+        return;
+    case RING_WAKEUP:
+        if (!completion.more) {
+            ring.pollReadable(reactor.loop.getWakeupFD(), ringTag(RING_WAKEUP));
+        }
+        reactor.loop.runPending();
+        return;
+    case RING_TICK:
+        closeIdleConnections(reactor);
+        ring.timeout(1000, ringTag(RING_TICK));
+        return;
+    case RING_CANCEL:
+        return;
+    default:
+        break;
+    }
+
+    auto it = reactor.ringConnections.find(completion.userData & RING_ID_MASK);
+    if (it == reactor.ringConnections.end()) {
+        if (completion.buffer >= 0) {
+            ring.releaseBuffer(completion.buffer);
+        }
+        return;
+    }
+    std::shared_ptr<Connection> conn = it->second;
+    Connection::RingState& state = conn->ring;
+
+    switch (op) {
+    case RING_RECEIVE:
+        onRingReceive(conn, completion);
+        break;
+    case RING_SEND:
+    case RING_SPLICE_IN:
+    case RING_SPLICE_OUT:
+        onRingWrite(conn, op, completion.result);
+        break;
+    case RING_CLOSE:
+        state.closing = false;
+        break;
+    }
+
+    // Retired once nothing it submitted can complete any more. A pipe still
+    // held was closed mid-file and may have bytes in it, so it goes too.
+    if (conn->closed && !state.receiving && state.writes == 0 && !state.closing) {
+        if (state.pipe.isOpen()) {
+            releasePipe(reactor, state.pipe, false);
+        }
+        reactor.ringConnections.erase(it);
+    }
+}
+
+void HttpServer::acceptRingConnection(Reactor& reactor, const RingCompletion& completion) {
+    // Multishot accept stops on errors; re-arm it
+    if (!completion.more && running) {
+        reactor.ring->accept(reactor.listener->getFD(), ringTag(RING_ACCEPT));
+    }
+
+    if (completion.result < 0) {
+        int error = -completion.result;
+        if (error != ECANCELED && error != EINTR && error != ECONNABORTED && running) {
+            Logger::error("Failed to accept connection: " + std::string(strerror(error)));
+        }
+        return;
+    }
+
+    int clientSocket = completion.result;
+    if (!running) {
+        closesocket(clientSocket);
+        return;
+    }
+
+    // The socket stays blocking: the ring waits for readiness itself
+    std::string clientIP = Socket::getPeerAddress(clientSocket);
+    Logger::debug([&] { return "New connection from: " + clientIP; });
+    auto conn = std::make_shared<Connection>(&reactor, clientSocket, clientIP);
+    conn->parser.setLimits(MAX_HEADER_SIZE, MAX_HEADER_COUNT, maxBodySize);
+    conn->ring.id = ++reactor.nextConnectionId;
+    reactor.connections[clientSocket] = conn;
+    reactor.ringConnections[conn->ring.id] = conn;
+    metrics.add(Metrics::CONNECTIONS_OPENED);
+
+    reactor.ring->receive(clientSocket, ringTag(RING_RECEIVE, conn->ring.id));
+    conn->ring.receiving = true;
+}
+
+void HttpServer::onRingReceive(const std::shared_ptr<Connection>& conn, const RingCompletion& completion) {
+    IoUring& ring = *conn->reactor->ring;
+    Connection::RingState& state = conn->ring;
+    if (!completion.more) {
+        state.receiving = false;
+    }
+
+    if (completion.buffer >= 0) {
+        if (completion.result > 0 && !conn->closed) {
+            metrics.add(Metrics::BYTES_RECEIVED, static_cast<uint64_t>(completion.result));
+            conn->inBuffer.append(ring.bufferData(completion.buffer), static_cast<size_t>(completion.result));
+            conn->lastActivity = std::chrono::steady_clock::now();
+        }
+        ring.releaseBuffer(completion.buffer);
+    }
+    if (conn->closed) {
+        return;
+    }
+
+    // Multishot receive keeps reading until cancelled; what arrives before
+    // the cancel lands is still kept
+    if (!conn->readPaused && isInputFull(*conn)) {
+        conn->readPaused = true;
+        if (state.receiving) {
+            ring.cancel(ringTag(RING_RECEIVE, state.id), ringTag(RING_CANCEL));
+        }
+    }
+
+    if (completion.result == 0) {
+        Logger::debug([&] { return "Client disconnected: " + conn->clientIP; });
+        conn->peerClosed = true;
+    } else if (completion.result < 0 && completion.result != -ENOBUFS && completion.result != -ECANCELED) {
+        Logger::error("Error receiving data from: " + conn->clientIP);
+        closeConnection(conn);
+        return;
+    }
+
+    // Multishot receive also stops when the provided buffers run dry
+    if (!state.receiving && !conn->peerClosed && !conn->readPaused) {
+        ring.receive(conn->fd, ringTag(RING_RECEIVE, state.id));
+        state.receiving = true;
+    }
+
+    onInputReceived(conn);
+}
+
+void HttpServer::submitWrite(const std::shared_ptr<Connection>& conn) {
+    Connection::RingState& state = conn->ring;
+    if (state.writes > 0 || conn->closed) {
+        return;
+    }
+    Reactor& reactor = *conn->reactor;
+    IoUring& ring = *reactor.ring;
+    OutputChunk& front = conn->outQueue.front();
+
+    if (front.isFile()) {
+        if (!state.pipe.isOpen() && !acquirePipe(reactor, state.pipe)) {
+            Logger::error("Failed to create splice pipe");
+            closeConnection(conn);
+            return;
+        }
+
+        if (state.pipeBytes > 0) {
+            // Left behind by a short splice-in
+            ring.splice(state.pipe.readFd, -1, conn->fd, static_cast<unsigned>(state.pipeBytes),
+                        ringTag(RING_SPLICE_OUT, state.id), false);
+            state.writes = 1;
+            return;
+        }
+
+        // File to pipe, then pipe to socket once the first has finished. The
+        // pipe must take the whole splice-in, or the link would never get to
+        // drain it; page cache pages fill one pipe slot each.
+        size_t pageOffset = static_cast<size_t>(front.fileOffset) % 4096;
+        size_t length = std::min(front.fileRemaining, state.pipe.capacity - pageOffset);
+        ring.splice(front.file->getFD(), front.fileOffset, state.pipe.writeFd, static_cast<unsigned>(length),
+                    ringTag(RING_SPLICE_IN, state.id), true);
+        ring.splice(state.pipe.readFd, -1, conn->fd, static_cast<unsigned>(length),
+                    ringTag(RING_SPLICE_OUT, state.id), false);
+        state.writes = 2;
+        return;
+    }
+
+    // Same gather as writeData, kept on the connection until it completes
+    state.iov.clear();
+    size_t offset = conn->outOffset;
+    bool moreFollows = false;
+    for (const auto& chunk : conn->outQueue) {
+        if (chunk.isFile()) {
+            moreFollows = true;
+            break;
+        }
+        if (state.iov.size() == MAX_IOVECS) {
+            break;
+        }
+        iovec entry;
+        entry.iov_base = const_cast<char*>(chunk.bytes()) + offset;
+        entry.iov_len = chunk.size() - offset;
+        state.iov.push_back(entry);
+        offset = 0;
+    }
+
+    state.message = msghdr{};
+    state.message.msg_iov = state.iov.data();
+    state.message.msg_iovlen = state.iov.size();
+    ring.sendmsg(conn->fd, &state.message, MSG_NOSIGNAL | (moreFollows ? MSG_MORE : 0),
+                 ringTag(RING_SEND, state.id));
+    state.writes = 1;
+}
+
+void HttpServer::onRingWrite(const std::shared_ptr<Connection>& conn, uint64_t op, int32_t result) {
+    Connection::RingState& state = conn->ring;
+    state.writes--;
+    if (conn->closed) {
+        return;
+    }
+
+    if (op == RING_SEND) {
+        if (result < 0) {
+            Logger::error("Failed to send response");
+            closeConnection(conn);
+            return;
+        }
+        onDataSent(*conn, static_cast<size_t>(result));
+    } else if (op == RING_SPLICE_IN) {
+        // A zero return means the file shrank underneath us
+        if (result <= 0) {
+            Logger::error("Failed to send file");
+            closeConnection(conn);
+            return;
+        }
+        state.pipeBytes += static_cast<size_t>(result);
+    } else if (result != -ECANCELED) {
+        // Cancelled means the splice-in came up short; what it did move is
+        // sent on its own next time
+        if (result < 0) {
+            Logger::error("Failed to send file");
+            closeConnection(conn);
+            return;
+        }
+        OutputChunk& chunk = conn->outQueue.front();
+        state.pipeBytes -= static_cast<size_t>(result);
+        chunk.fileOffset += result;
+        chunk.fileRemaining -= static_cast<size_t>(result);
+        metrics.add(Metrics::BYTES_SENT, static_cast<uint64_t>(result));
+        conn->lastActivity = std::chrono::steady_clock::now();
+        if (chunk.fileRemaining == 0) {
+            conn->outQueue.pop_front();
+            releasePipe(*conn->reactor, state.pipe, true);
+        }
+    }
+
+    if (state.writes == 0) {
+        flushConnection(conn);
+    }
+}
+
+bool HttpServer::acquirePipe(Reactor& reactor, SplicePipe& pipe) {
+    if (!reactor.idlePipes.empty()) {
+        pipe = reactor.idlePipes.back();
+        reactor.idlePipes.pop_back();
+        return true;
+    }
+
+    int fds[2];
+    if (pipe2(fds, O_CLOEXEC) != 0) {
+        return false;
+    }
+    // Best effort; a pipe stuck at the default size just splices less at a time
+    fcntl(fds[1], F_SETPIPE_SZ, RING_PIPE_SIZE);
+    int capacity = fcntl(fds[1], F_GETPIPE_SZ);
+    pipe.readFd = fds[0];
+    pipe.writeFd = fds[1];
+    pipe.capacity = capacity > 0 ? static_cast<size_t>(capacity) : 4096;
+    return true;
+}
+
+void HttpServer::releasePipe(Reactor& reactor, SplicePipe& pipe, bool empty) {
+    // Only an empty pipe can carry the next file
+    if (empty && reactor.idlePipes.size() < MAX_IDLE_PIPES) {
+        reactor.idlePipes.push_back(pipe);
+    } else {
+        ::close(pipe.readFd);
+        ::close(pipe.writeFd);
+    }
+    pipe = SplicePipe();
+}
+
+void HttpServer::route(HttpMethod method, const std::string& pattern, RouteHandler handler) {
+    router.add(method, pattern, std::move(handler), routeTag(pattern));
+}
+
+size_t HttpServer::routeTag(const std::string& pattern) {
+    // One metrics series per pattern, whatever the method
+    auto tag = routeTags.find(pattern);
+    if (tag == routeTags.end()) {
+        tag = routeTags.emplace(pattern, metrics.addRoute(pattern)).first;
+    }
+    return tag->second;
+}
+
+#ifdef HTTPSERVER_COROUTINES
+void HttpServer::routeAsync(HttpMethod method, const std::string& pattern, AsyncRouteHandler handler) {
+    // The router only knows the route exists; processRequest parks the
+    // batch when it matches and runAsyncRoute drives the handler
+    const Router::Route& added = router.add(method, pattern, RouteHandler(), routeTag(pattern));
+    asyncRoutes[&added] = std::move(handler);
+}
+
+Offload<std::optional<std::string>> HttpServer::readFileAsync(std::string path) {
+    return offload<std::optional<std::string>>([path = std::move(path)]() -> std::optional<std::string> {
+        std::shared_ptr<FileHandle> file = FileHandler::openFile(path);
+        std::string content;
+        if (!file || !FileHandler::readFile(*file, content)) {
+            return std::nullopt;
+        }
+        return content;
+    });
+}
+
+Detached HttpServer::runAsyncRoute(std::shared_ptr<Connection> conn, std::shared_ptr<WorkBatch> work) {
+    HttpResponse response;
+    try {
+        const AsyncRouteHandler& handler = asyncRoutes.at(work->asyncRoute);
+        response = co_await handler(work->requests[work->next], work->asyncParams);
+    } catch (const std::exception& e) {
+        Logger::error("Error processing request: " + std::string(e.what()));
+        response = HttpResponse::makeErrorResponse(500, "Internal Server Error");
+        response.setCorsPolicy(CorsPolicy::ALLOW_ORIGIN);
+    }
+
+    // Back on the loop: the batch picks the response up where it stopped
+    work->asyncResponse = std::make_unique<HttpResponse>(std::move(response));
+    if (!conn->closed) {
+        schedule(conn, std::move(work));
+    }
+}
+#endif
+
+void HttpServer::registerRoutes() {
+#ifdef HTTPSERVER_COROUTINES
+    // Opening the web root can block on a cold disk, which would stall an
+    // inline reactor; a worker does it while the loop carries on
+    routeAsync(HttpMethod::GET, "/api/directory",
+               [this](const HttpRequest&, const RouteParams&) -> Task<HttpResponse> {
+        co_return co_await offload<HttpResponse>([this]() { return handleApiDirectory(); });
+    });
+#else
+    route(HttpMethod::GET, "/api/directory", [this](const HttpRequest&, const RouteParams&) {
+        return handleApiDirectory();
+    });
+#endif
+    route(HttpMethod::GET, "/api/status", [this](const HttpRequest&, const RouteParams&) {
+        return handleApiStatus();
+    });
+    route(HttpMethod::GET, "/api/metrics", [this](const HttpRequest& request, const RouteParams&) {
+        return handleApiMetrics(request);
+    });
+    route(HttpMethod::POST, "/api/test", [this](const HttpRequest& request, const RouteParams&) {
+        return handleApiTest(request);
+    });
+
+    // Everything else is a static file, an echoed POST, or a CORS preflight
+    route(HttpMethod::GET, "/*path", [this](const HttpRequest& request, const RouteParams&) {
+        return handleStatic(request);
+    });
+    route(HttpMethod::POST, "/*path", [this](const HttpRequest& request, const RouteParams&) {
+        return handleEcho(request);
+    });
+    route(HttpMethod::OPTIONS, "/*path", [](const HttpRequest&, const RouteParams&) {
+        HttpResponse optionsResponse;
+        optionsResponse.setStatusCode(200);
+        optionsResponse.setStatusMessage("OK");
+        optionsResponse.setCorsPolicy(CorsPolicy::FULL);
+        optionsResponse.setHeader("Access-Control-Max-Age", "86400");
+        return optionsResponse;
+    });
+}
+
+HttpResponse HttpServer::processRequest(const HttpRequest& request, bool& keepAlive, size_t& route,
+                                        [[maybe_unused]] WorkBatch& work) {
+    keepAlive = false;
+    try {
+        keepAlive = request.isKeepAlive();
+
+#ifdef HTTPSERVER_COROUTINES
+        // Second pass over a request a coroutine route has answered
+        if (work.asyncResponse) {
+            route = work.asyncRoute->tag;
+            HttpResponse response = std::move(*work.asyncResponse);
+            work.asyncResponse.reset();
+            work.asyncRoute = nullptr;
+            if (request.getMethod() == HttpMethod::HEAD) {
+                response.stripBody();
+            }
+            return response;
+        }
+#endif
+
+        if (request.getMethod() == HttpMethod::UNKNOWN) {
+            // Send 501 Not Implemented
+            HttpResponse notImplemented = HttpResponse::makeErrorResponse(501, "Not Implemented");
+            notImplemented.setCorsPolicy(CorsPolicy::FULL);
+            return notImplemented;
+        }
+
+        Router::Match match = router.match(request.getMethod(), request.getPath());
+        if (!match.route) {
+            HttpResponse notAllowed = HttpResponse::makeErrorResponse(405, "Method Not Allowed");
+            notAllowed.setHeader("Allow", Router::formatAllowed(match.allowed));
+            notAllowed.setCorsPolicy(CorsPolicy::FULL);
+            return notAllowed;
+        }
+
+        route = match.route->tag;
+#ifdef HTTPSERVER_COROUTINES
+        if (!match.route->handler) {
+            work.asyncRoute = match.route;
+            work.asyncParams = match.params;
+            return HttpResponse();
+        }
+#endif
+        HttpResponse response = match.route->handler(request, match.params);
+
+        // HEAD gets the same headers as GET, including validators and 304s
+        if (request.getMethod() == HttpMethod::HEAD) {
+            response.stripBody();
+        }
+        return response;
+
+    } catch (const std::exception& e) {
+        Logger::error("Error processing request: " + std::string(e.what()));
+        HttpResponse error = HttpResponse::makeErrorResponse(500, "Internal Server Error");
+        error.setCorsPolicy(CorsPolicy::ALLOW_ORIGIN);
+        return error;
+    }
+}
+
+HttpResponse HttpServer::handleStatic(const HttpRequest& request) {
+    std::string path(request.getPath());
+    HttpResponse response = serveStaticFile(request, path);
+
+    // Files carry validators; let the client revalidate instead of refetching
+    if (response.getStatusCode() == 200 && !response.getHeader("ETag").empty()) {
+        std::string cacheControl = getCacheControl(path);
+        if (!cacheControl.empty()) {
+            response.setHeader("Cache-Control", cacheControl);
+        }
+        if (isNotModified(request, response)) {
+            response.setNotModified();
+        } else if (!request.getHeader(HeaderId::RANGE).empty()) {
+            applyRange(request, response);
+        }
+    }
+
+    return response;
+}
+
+void HttpServer::applyRange(const HttpRequest& request, HttpResponse& response) {
+    // Ranges are only served on the identity representation, sliced out of
+    // the cached bytes or the file without reading the rest
+    const BodySegments& segments = response.getBodySegments();
+    if (segments.size() != 1 || !response.getHeader("Content-Encoding").empty()) {
+        return;
+    }
+
+    // If-Range: only honor the range if the client still has this version
+    std::string_view ifRange = request.getHeader(HeaderId::IF_RANGE);
+    if (!ifRange.empty()) {
+        bool isEntityTag = ifRange[0] == '"' || ifRange.compare(0, 2, "W/") == 0;
+        bool matches = isEntityTag ? ifRange == response.getHeader("ETag")
+                                   : ifRange == response.getHeader("Last-Modified");
+        if (!matches) {
+            return;
+        }
+    }
+
+    BodySegment whole = segments[0];
+    size_t totalSize = whole.length;
+
+    std::vector<ByteRange> ranges;
+    RangeResult result = Range::parse(request.getHeader(HeaderId::RANGE), totalSize, ranges);
+    if (result == RangeResult::IGNORE) {
+        return;
+    }
+
+    if (result == RangeResult::UNSATISFIABLE) {
+        response = HttpResponse::makeErrorResponse(416, "Range Not Satisfiable");
+        response.setHeader("Content-Range", "bytes */" + std::to_string(totalSize));
+        response.setCorsPolicy(CorsPolicy::ALLOW_ORIGIN);
+        return;
+    }
+
+    response.setStatusCode(206);
+    if (ranges.size() == 1) {
+        response.setHeader("Content-Range", Range::formatContentRange(ranges[0], totalSize));
+        BodySegments slice(RequestArena::current());
+        slice.push_back(whole.slice(ranges[0].first, ranges[0].length()));
+        response.setBodySegments(std::move(slice));
+        return;
+    }
+
+    // Several ranges go out as multipart/byteranges, each part referencing
+    // the same source
+    static std::atomic<uint64_t> boundaryCounter{0};
+    char boundary[40];
+    snprintf(boundary, sizeof(boundary), "%016llx%08llx",
+             static_cast<unsigned long long>(time(nullptr)),
+             static_cast<unsigned long long>(boundaryCounter.fetch_add(1, std::memory_order_relaxed)));
+
+    std::string contentType(response.getHeader("Content-Type"));
+    BodySegments parts(RequestArena::current());
+    for (const auto& range : ranges) {
+        std::string partHeader = "\r\n--" + std::string(boundary) + "\r\n";
+        partHeader += "Content-Type: " + contentType + "\r\n";
+        partHeader += "Content-Range: " + Range::formatContentRange(range, totalSize) + "\r\n\r\n";
+        parts.push_back(BodySegment::fromString(partHeader));
+        parts.push_back(whole.slice(range.first, range.length()));
+    }
+    parts.push_back(BodySegment::fromString("\r\n--" + std::string(boundary) + "--\r\n"));
+
+    response.setContentType("multipart/byteranges; boundary=" + std::string(boundary));
+    response.setBodySegments(std::move(parts));
+}
+
+HttpResponse HttpServer::serveStaticFile(const HttpRequest& request, std::string path) {
+    // Default to index.html if root path
+    if (path == "/") {
+        path = "/index.html";
+    }
+
+    // Get safe file path
+    std::string filePath = webRoot + path;
+
+    // Cached files were validated when they were loaded; a hit needs no
+    // filesystem access at all
+    if (fileCache) {
+        if (auto cached = fileCache->get(FileCache::normalizeKey(filePath))) {
+            return makeCachedFileResponse(request, *cached);
+        }
+    }
+
+    if (!FileHandler::isPathSafe(webRoot, filePath)) {
+        HttpResponse response = HttpResponse::makeErrorResponse(403, "Forbidden");
+        response.setCorsPolicy(CorsPolicy::ALLOW_ORIGIN);
+        return response;
+    }
+
+    if (!FileHandler::fileExists(filePath) && !FileHandler::isDirectory(filePath)) {
+        HttpResponse response = HttpResponse::makeErrorResponse(404, "Not Found");
+        response.setCorsPolicy(CorsPolicy::ALLOW_ORIGIN);
+        return response;
+    }
+
+    // Check if it's a directory
+    if (FileHandler::isDirectory(filePath)) {
+        bool enableListing = config.getBool("security.enable_directory_listing", false);
+        std::string defaultIndex = config.getString("security.default_index", "index.html");
+
+        // Try default index file
+        std::string indexFile = filePath + "/" + defaultIndex;
+        if (FileHandler::fileExists(indexFile)) {
+            filePath = indexFile;
+        } else if (enableListing) {
+            // Generate directory listing
+            HttpResponse response;
+            response.setStatusCode(200);
+            response.setStatusMessage("OK");
+            response.setContentType("text/html");
+            response.setCorsPolicy(CorsPolicy::ALLOW_ORIGIN);
+            response.setBodyProducer(generateDirectoryListing(filePath, path));
+            return response;
+        } else {
+            HttpResponse response = HttpResponse::makeErrorResponse(403, "Forbidden");
+            response.setCorsPolicy(CorsPolicy::ALLOW_ORIGIN);
+            return response;
+        }
+    }
+
+    std::shared_ptr<FileHandle> file = FileHandler::openFile(filePath);
+    if (!file) {
+        HttpResponse response = HttpResponse::makeErrorResponse(404, "Not Found");
+        response.setCorsPolicy(CorsPolicy::ALLOW_ORIGIN);
+        return response;
+    }
+
+    // Small files are loaded into the cache and served from memory
+    if (fileCache && fileCache->isCacheable(file->getSize())) {
+        if (auto cached = loadCachedFile(filePath, *file, true)) {
+            return makeCachedFileResponse(request, *cached);
+        }
+    }
+
+    // Serve the file; the body is streamed from the descriptor with sendfile
+    std::string mimeType = FileHandler::getMimeType(filePath);
+    HttpResponse response;
+    response.setStatusCode(200);
+    response.setStatusMessage("OK");
+    response.setContentType(mimeType);
+    response.setCorsPolicy(CorsPolicy::ALLOW_ORIGIN);
+
+    // Too large to compress on the fly, but a precompressed sibling may exist
+    if (compressionEnabled) {
+        if (Compression::isCompressible(mimeType)) {
+            response.setHeader("Vary", "Accept-Encoding");
+        }
+        for (ContentEncoding encoding : Compression::parseAcceptEncoding(request.getHeader(HeaderId::ACCEPT_ENCODING))) {
+            if (encoding == ContentEncoding::IDENTITY) {
+                break;
+            }
+            if (*Compression::getFileSuffix(encoding) && setSiblingBody(response, filePath, encoding)) {
+                response.setHeader("Content-Encoding", Compression::getName(encoding));
+                response.setHeader("Vary", "Accept-Encoding");
+                return response;
+            }
+        }
+    }
+
+    setValidators(response, file->getSize(), file->getInfo().st_mtime, file->getInfo().st_ino,
+                  ContentEncoding::IDENTITY);
+    response.setHeader("Accept-Ranges", "bytes");
+    response.setFileBody(file, 0, file->getSize());
+    return response;
+}
+
+std::shared_ptr<const CachedFile> HttpServer::loadCachedFile(const std::string& filePath, const FileHandle& file,
+                                                             bool checkSiblings) {
+    // Taken before reading so a change during the read keeps it out of the cache
+    uint64_t generation = fileCache->getGeneration();
+
+    auto content = std::make_shared<std::string>();
+    if (!FileHandler::readFile(file, *content)) {
+        return nullptr;
+    }
+
+    auto entry = std::make_shared<CachedFile>();
+    entry->path = FileCache::normalizeKey(filePath);
+    entry->content = std::move(content);
+    entry->mimeType = FileHandler::getMimeType(filePath);
+    entry->size = entry->content->size();
+    entry->modifiedTime = file.getInfo().st_mtime;
+    entry->inode = file.getInfo().st_ino;
+
+    if (checkSiblings && compressionEnabled) {
+        entry->hasGzipSibling = FileHandler::fileExists(entry->path + ".gz");
+        entry->hasBrotliSibling = FileHandler::fileExists(entry->path + ".br");
+    }
+
+    fileCache->put(entry, generation);
+    return entry;
+}
+
+HttpResponse HttpServer::makeCachedFileResponse(const HttpRequest& request, const CachedFile& cached) {
+    HttpResponse response;
+    response.setStatusCode(200);
+    response.setStatusMessage("OK");
+    response.setContentType(cached.mimeType);
+    response.setCorsPolicy(CorsPolicy::ALLOW_ORIGIN);
+
+    bool negotiable = compressionEnabled &&
+        (Compression::isCompressible(cached.mimeType) || cached.hasGzipSibling || cached.hasBrotliSibling);
+    if (negotiable) {
+        response.setHeader("Vary", "Accept-Encoding");
+
+        // Precompressed siblings win over compressing on the fly
+        for (ContentEncoding encoding : Compression::parseAcceptEncoding(request.getHeader(HeaderId::ACCEPT_ENCODING))) {
+            if (encoding == ContentEncoding::IDENTITY) {
+                break;
+            }
+
+            bool hasSibling = (encoding == ContentEncoding::GZIP && cached.hasGzipSibling) ||
+                              (encoding == ContentEncoding::BROTLI && cached.hasBrotliSibling);
+            if (hasSibling && setSiblingBody(response, cached.path, encoding)) {
+                response.setHeader("Content-Encoding", Compression::getName(encoding));
+                return response;
+            }
+
+            if (auto variant = getCompressedVariant(cached, encoding)) {
+                response.setHeader("Content-Encoding", Compression::getName(encoding));
+                response.setSharedBody(variant);
+                setValidators(response, cached.size, cached.modifiedTime, cached.inode, encoding);
+                return response;
+            }
+        }
+    }
+
+    setValidators(response, cached.size, cached.modifiedTime, cached.inode, ContentEncoding::IDENTITY);
+    response.setHeader("Accept-Ranges", "bytes");
+    response.setSharedBody(cached.content);
+    return response;
+}
+
+void HttpServer::setValidators(HttpResponse& response, size_t size, time_t modifiedTime, ino_t inode,
+                               ContentEncoding encoding) {
+    // Strong validator: any change to the file changes at least one of
+    // inode, size or mtime. Each encoding is a distinct representation.
+    char etag[96];
+    snprintf(etag, sizeof(etag), "\"%llx-%zx-%llx%s%s\"",
+             static_cast<unsigned long long>(inode), size, static_cast<unsigned long long>(modifiedTime),
+             encoding == ContentEncoding::IDENTITY ? "" : "-",
+             encoding == ContentEncoding::IDENTITY ? "" : Compression::getName(encoding));
+
+    response.setHeader("ETag", etag);
+    char lastModified[HttpResponse::HTTP_DATE_SIZE];
+    response.setHeader("Last-Modified", HttpResponse::formatHttpDate(modifiedTime, lastModified));
+}
+
+bool HttpServer::isNotModified(const HttpRequest& request, const HttpResponse& response) {
+    // If-None-Match takes precedence; it uses weak comparison
+    std::string_view ifNoneMatch = request.getHeader(HeaderId::IF_NONE_MATCH);
+    if (!ifNoneMatch.empty()) {
+        std::string_view etag = response.getHeader("ETag");
+        size_t pos = 0;
+        while (pos < ifNoneMatch.size()) {
+            size_t comma = ifNoneMatch.find(',', pos);
+            if (comma == std::string_view::npos) comma = ifNoneMatch.size();
+
+            size_t start = ifNoneMatch.find_first_not_of(" \t", pos);
+            size_t end = ifNoneMatch.find_last_not_of(" \t", comma - 1);
+            pos = comma + 1;
+            if (start == std::string_view::npos || start > end) {
+                continue;
+            }
+
+            std::string_view candidate = ifNoneMatch.substr(start, end - start + 1);
+            if (candidate.compare(0, 2, "W/") == 0) {
+                candidate.remove_prefix(2);
+            }
+            if (candidate == "*" || candidate == etag) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::string_view ifModifiedSince = request.getHeader(HeaderId::IF_MODIFIED_SINCE);
+    if (!ifModifiedSince.empty()) {
+        time_t since = HttpRequest::parseHttpDate(ifModifiedSince);
+        time_t modified = HttpRequest::parseHttpDate(response.getHeader("Last-Modified"));
+        return since >= 0 && modified >= 0 && modified <= since;
+    }
+
+    return false;
+}
+
+std::string HttpServer::getCacheControl(const std::string& path) const {
+    // Sorted longest prefix first at startup
+    for (const auto& rule : cacheControlRules) {
+        if (path.compare(0, rule.first.size(), rule.first) == 0) {
+            return rule.second;
+        }
+    }
+    return "";
+}
+
+std::shared_ptr<const std::string> HttpServer::getCompressedVariant(const CachedFile& cached, ContentEncoding encoding) {
+    if (!Compression::canCompress(encoding) || !Compression::isCompressible(cached.mimeType) ||
+        cached.size < compressionMinSize) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(cached.variantMutex);
+    std::shared_ptr<const std::string>& variant =
+        encoding == ContentEncoding::GZIP ? cached.gzipVariant : cached.deflateVariant;
+
+    if (!variant) {
+        auto compressed = std::make_shared<std::string>();
+        if (Compression::compress(*cached.content, encoding, *compressed, compressionLevel) &&
+            compressed->size() < cached.size) {
+            variant = std::move(compressed);
+        } else {
+            // Remember that compressing doesn't pay off for this file
+            variant = cached.content;
+        }
+    }
+
+    return variant == cached.content ? nullptr : variant;
+}
+
+bool HttpServer::setSiblingBody(HttpResponse& response, const std::string& filePath, ContentEncoding encoding) {
+    std::string siblingPath = filePath + Compression::getFileSuffix(encoding);
+
+    if (fileCache) {
+        if (auto cached = fileCache->get(FileCache::normalizeKey(siblingPath))) {
+            setValidators(response, cached->size, cached->modifiedTime, cached->inode, encoding);
+            response.setSharedBody(cached->content);
+            return true;
+        }
+    }
+
+    std::shared_ptr<FileHandle> file = FileHandler::openFile(siblingPath);
+    if (!file) {
+        return false;
+    }
+
+    // Validated by the sibling's own stat: it can be regenerated without
+    // the original changing
+    setValidators(response, file->getSize(), file->getInfo().st_mtime, file->getInfo().st_ino, encoding);
+    if (fileCache && fileCache->isCacheable(file->getSize())) {
+        if (auto cached = loadCachedFile(siblingPath, *file, false)) {
+            response.setSharedBody(cached->content);
+            return true;
+        }
+    }
+
+    response.setFileBody(file, 0, file->getSize());
+    return true;
+}
+
+HttpResponse HttpServer::handleEcho(const HttpRequest& request) {
+    // Simple echo server for POST requests without a route of their own
+    HttpResponse response;
+    response.setStatusCode(200);
+    response.setStatusMessage("OK");
+    response.setContentType("text/plain");
+    response.setCorsPolicy(CorsPolicy::ALLOW_ORIGIN);
+    std::string body = "Received POST request with body: ";
+    body.reserve(body.size() + request.getContentLength());
+    for (std::string_view chunk : request.getBodyChunks()) {
+        body.append(chunk);
+    }
+    response.setBody(body);
+
+    return response;
+}
+
+HttpResponse HttpServer::handleApiDirectory() {
+    // Streamed, so a large web root starts arriving before it is fully read
+    auto reader = std::make_shared<DirectoryReader>(webRoot);
+    bool started = false;
+
+    HttpResponse response;
+    response.setStatusCode(200);
+    response.setStatusMessage("OK");
+    response.setContentType("application/json");
+    response.setCorsPolicy(CorsPolicy::ALLOW_ORIGIN);
+    response.setBodyProducer([this, reader, started](std::string& chunk) mutable {
+        if (!started) {
+            chunk += "[\n";
+        }
+
+        DirectoryEntry entry;
+        for (size_t i = 0; i < LISTING_BATCH_SIZE; ++i) {
+            if (!reader->next(entry)) {
+                chunk += "\n]";
+                return false;
+            }
+            if (started) {
+                chunk += ",\n";
+            }
+            started = true;
+
+            chunk += "  {\"name\": \"" + escapeJsonString(entry.name) + "\", ";
+            chunk += "\"path\": \"" + escapeJsonString(entry.name) + "\", ";
+            chunk += std::string("\"isDirectory\": ") + (entry.isDirectory ? "true" : "false") + ", ";
+            chunk += "\"size\": " + std::to_string(entry.size) + "}";
+        }
+        return true;
+    });
+    return response;
+}
+
+HttpResponse HttpServer::handleApiStatus() {
+    auto now = std::chrono::steady_clock::now();
+    auto uptime = std::chrono::duration_cast<std::chrono::seconds>(now - startTime);
+
+    int hours = uptime.count() / 3600;
+    int minutes = (uptime.count() % 3600) / 60;
+    int seconds = uptime.count() % 60;
+
+    char uptimeStr[16];
+    snprintf(uptimeStr, sizeof(uptimeStr), "%02d:%02d:%02d", hours, minutes, seconds);
+
+    std::string json = "{";
+    json += "\"status\": \"running\", ";
+    json += "\"port\": " + std::to_string(config.getInt("server.port", 8080)) + ", ";
+    json += "\"webRoot\": \"" + escapeJsonString(webRoot) + "\", ";
+    json += "\"threads\": " + std::to_string(config.getInt("server.max_threads", 4)) + ", ";
+    json += "\"uptime\": \"" + std::string(uptimeStr) + "\"";
+    json += "}";
+
+    HttpResponse response;
+    response.setStatusCode(200);
+    response.setStatusMessage("OK");
+    response.setContentType("application/json");
+    response.setCorsPolicy(CorsPolicy::ALLOW_ORIGIN);
+    response.setBody(json);
+    return response;
+}
+
+HttpResponse HttpServer::handleApiMetrics(const HttpRequest& request) {
+    auto uptime = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - startTime);
+
+    std::vector<MetricValue> extra;
+    extra.push_back({"uptime_seconds", "Seconds since the server started", false,
+                     static_cast<double>(uptime.count())});
+    extra.push_back({"thread_pool_queue_depth", "Tasks waiting for a worker thread", false,
+                     threadPool ? static_cast<double>(threadPool->getQueueDepth()) : 0.0});
+    if (fileCache) {
+        uint64_t hits = fileCache->getHits();
+        uint64_t misses = fileCache->getMisses();
+        extra.push_back({"file_cache_hits_total", "Static file cache hits", true, static_cast<double>(hits)});
+        extra.push_back({"file_cache_misses_total", "Static file cache misses", true, static_cast<double>(misses)});
+        extra.push_back({"file_cache_hit_ratio", "Static file cache hits over lookups", false,
+                         hits + misses > 0 ? static_cast<double>(hits) / static_cast<double>(hits + misses) : 0.0});
+    }
+    extra.push_back({"arena_overflows_total", "Request arena allocations that fell back to the heap", true,
+                     static_cast<double>(RequestArena::getOverflowCount())});
+    extra.push_back({"log_messages_dropped_total", "Log records dropped because the logger fell behind", true,
+                     static_cast<double>(Logger::getDroppedCount())});
+
+    // Prometheus scrapes get the text format; ?format=json or an Accept of
+    // application/json gets JSON
+    bool json = request.getQueryParam("format") == "json" ||
+                request.getHeader(HeaderId::ACCEPT).find("application/json") != std::string_view::npos;
+
+    HttpResponse response;
+    response.setStatusCode(200);
+    response.setStatusMessage("OK");
+    response.setHeader("Cache-Control", "no-store");
+    response.setCorsPolicy(CorsPolicy::ALLOW_ORIGIN);
+    if (json) {
+        response.setContentType("application/json");
+        response.setBody(metrics.renderJson(extra));
+    } else {
+        response.setContentType("text/plain; version=0.0.4; charset=utf-8");
+        response.setBody(metrics.renderPrometheus(extra));
+    }
+    return response;
+}
+
+HttpResponse HttpServer::handleApiTest(const HttpRequest& request) {
+    std::string jsonResponse = "{";
+    jsonResponse += "\"status\": \"success\", ";
+    jsonResponse += "\"message\": \"POST request received\", ";
+    jsonResponse += "\"receivedBody\": \"";
+    for (std::string_view chunk : request.getBodyChunks()) {
+        jsonResponse += escapeJsonString(chunk);
+    }
+    jsonResponse += "\", ";
+    jsonResponse += "\"timestamp\": \"" + getCurrentTimestamp() + "\"";
+    jsonResponse += "}";
+
+    HttpResponse response;
+    response.setStatusCode(200);
+    response.setStatusMessage("OK");
+    response.setContentType("application/json");
+    response.setCorsPolicy(CorsPolicy::ALLOW_ORIGIN);
+    response.setBody(jsonResponse);
+    return response;
+}
+
+BodyProducer HttpServer::generateDirectoryListing(const std::string& dirPath, const std::string& urlPath) {
+    auto reader = std::make_shared<DirectoryReader>(dirPath);
+    bool started = false;
+
+    // Links are built from the path without its trailing slash; "" for the root
+    std::string base = urlPath;
+    while (!base.empty() && base.back() == '/') {
+        base.pop_back();
+    }
+
+    return [reader, base, started](std::string& chunk) mutable {
+        if (!started) {
+            started = true;
+            chunk += "<!DOCTYPE html>\n";
+            chunk += "<html><head><title>Directory Listing</title></head>\n";
+            chunk += "<body>\n";
+            chunk += "<h1>Directory Listing: " + escapeHtml(base + "/") + "</h1>\n";
+            chunk += "<ul>\n";
+
+            // Parent directory link
+            if (!base.empty()) {
+                std::string parentPath = base.substr(0, base.find_last_of('/') + 1);
+                chunk += "<li><a href=\"" + escapeHtml(parentPath) + "\">../</a></li>\n";
+            }
+        }
+
+        // List files
+        DirectoryEntry entry;
+        for (size_t i = 0; i < LISTING_BATCH_SIZE; ++i) {
+            if (!reader->next(entry)) {
+                chunk += "</ul>\n";
+                chunk += "</body></html>";
+                return false;
+            }
+            std::string file = escapeHtml(entry.isDirectory ? entry.name + "/" : entry.name);
+            chunk += "<li><a href=\"" + escapeHtml(base) + "/" + file + "\">" + file + "</a></li>\n";
+        }
+        return true;
+    };
+}
+
+std::string HttpServer::escapeHtml(std::string_view str) {
+    std::string result;
+    for (char c : str) {
+        switch (c) {
+            case '&': result += "&amp;"; break;
+            case '<': result += "&lt;"; break;
+            case '>': result += "&gt;"; break;
+            case '"': result += "&quot;"; break;
+            case '\'': result += "&#39;"; break;
+            default: result += c; break;
+        }
+    }
+    return result;
+}
+
+std::string HttpServer::escapeJsonString(std::string_view str) {
+    std::string result;
+    for (char c : str) {
+        switch (c) {
+            case '"': result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\b': result += "\\b"; break;
+            case '\f': result += "\\f"; break;
+            case '\n': result += "\\n"; break;
+            case '\r': result += "\\r"; break;
+            case '\t': result += "\\t"; break;
+            default: result += c; break;
+        }
+    }
+    return result;
+}
+
+std::string HttpServer::getCurrentTimestamp() {
+    time_t now = time(nullptr);
+    char buffer[80];
+    strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", localtime(&now));
+    return std::string(buffer);
+}
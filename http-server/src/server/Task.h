@@ -0,0 +1,151 @@
+// src/server/Task.h
+#pragma once
+
+// Coroutine route handlers, built with -DENABLE_COROUTINES=ON (C++20).
+// The default C++17 build leaves this header empty.
+#ifdef HTTPSERVER_COROUTINES
+
+#if !defined(__cpp_impl_coroutine)
+#error "HTTPSERVER_COROUTINES needs a compiler with C++20 coroutines"
+#endif
+
+#include "EventLoop.h"
+#include "ThreadPool.h"
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <utility>
+
+template<typename T>
+class Task;
+
+namespace detail {
+
+// Resumes whoever awaited the task once it finishes
+struct FinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+
+    template<typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> finished) noexcept {
+        std::coroutine_handle<> continuation = finished.promise().continuation;
+        return continuation ? continuation : std::noop_coroutine();
+    }
+
+    void await_resume() const noexcept {}
+};
+
+struct PromiseBase {
+    std::coroutine_handle<> continuation;
+    std::exception_ptr exception;
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() { exception = std::current_exception(); }
+};
+
+} // namespace detail
+
+// A lazily started coroutine producing a T. Nothing runs until the task is
+// awaited; the awaiting coroutine is then suspended until the task
+// finishes, and resumed on whichever thread finished it. Exceptions thrown
+// inside come out of the co_await.
+template<typename T>
+class Task {
+public:
+    struct promise_type : detail::PromiseBase {
+        std::optional<T> value;
+
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+
+        template<typename U>
+        void return_value(U&& result) { value.emplace(std::forward<U>(result)); }
+    };
+
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            reset();
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    ~Task() { reset(); }
+
+    bool await_ready() const noexcept { return !handle || handle.done(); }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+    }
+
+    T await_resume() {
+        promise_type& promise = handle.promise();
+        if (promise.exception) {
+            std::rethrow_exception(promise.exception);
+        }
+        return std::move(*promise.value);
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle;
+
+    explicit Task(std::coroutine_handle<promise_type> coroutine) : handle(coroutine) {}
+
+    void reset() {
+        if (handle) {
+            handle.destroy();
+            handle = nullptr;
+        }
+    }
+};
+
+// Fire and forget: starts at once and frees itself when it returns. Only
+// for the coroutine at the bottom of a chain, which must catch everything.
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() const noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+};
+
+// Runs blocking work on a thread pool while the awaiting coroutine is
+// suspended, then resumes it on the event loop it was suspended from. The
+// loop thread is free for other connections in the meantime.
+template<typename T>
+class Offload {
+public:
+    Offload(ThreadPool& workers, std::function<T()> job) : pool(workers), work(std::move(job)) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> awaiting) {
+        EventLoop* loop = EventLoop::current();
+        pool.enqueue([this, awaiting, loop]() {
+            try {
+                result.emplace(work());
+            } catch (...) {
+                exception = std::current_exception();
+            }
+            loop->post([awaiting]() { awaiting.resume(); });
+        });
+    }
+
+    T await_resume() {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+        return std::move(*result);
+    }
+
+private:
+    ThreadPool& pool;
+    std::function<T()> work;
+    std::optional<T> result;
+    std::exception_ptr exception;
+};
+
+#endif
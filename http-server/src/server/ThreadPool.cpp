@@ -0,0 +1,313 @@
+// src/server/ThreadPool.cpp
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace {
+
+// Which pool, if any, the calling thread is a worker of
+thread_local ThreadPool* currentPool = nullptr;
+thread_local size_t currentIndex = 0;
+
+}
+
+ThreadPool::WorkDeque::WorkDeque() : top(0), bottom(0), buffer(new Buffer(256)) {}
+
+ThreadPool::WorkDeque::~WorkDeque() {
+    Buffer* current = buffer.load(std::memory_order_relaxed);
+    for (int64_t i = top.load(std::memory_order_relaxed); i < bottom.load(std::memory_order_relaxed); ++i) {
+        delete current->get(i);
+    }
+    delete current;
+}
+
+ThreadPool::WorkDeque::Buffer* ThreadPool::WorkDeque::grow(Buffer* old, int64_t b, int64_t t) {
+    Buffer* larger = new Buffer(old->capacity * 2);
+    for (int64_t i = t; i < b; ++i) {
+        larger->put(i, old->get(i));
+    }
+    retired.emplace_back(old);
+    buffer.store(larger, std::memory_order_release);
+    return larger;
+}
+
+void ThreadPool::WorkDeque::push(Task* task) {
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_acquire);
+    Buffer* current = buffer.load(std::memory_order_relaxed);
+    if (b - t > static_cast<int64_t>(current->capacity) - 1) {
+        current = grow(current, b, t);
+    }
+    current->put(b, task);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_relaxed);
+}
+
+ThreadPool::Task* ThreadPool::WorkDeque::pop() {
+    int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    Buffer* current = buffer.load(std::memory_order_relaxed);
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_relaxed);
+
+    if (t > b) {
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Task* task = current->get(b);
+    if (t == b) {
+        // Last element: race the thieves for it
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            task = nullptr;
+        }
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return task;
+}
+
+ThreadPool::Task* ThreadPool::WorkDeque::steal() {
+    int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom.load(std::memory_order_acquire);
+    if (t >= b) {
+        return nullptr;
+    }
+
+    Buffer* current = buffer.load(std::memory_order_acquire);
+    Task* task = current->get(t);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return task;
+}
+
+bool ThreadPool::WorkDeque::empty() const {
+    return top.load(std::memory_order_acquire) >= bottom.load(std::memory_order_acquire);
+}
+
+size_t ThreadPool::WorkDeque::size() const {
+    int64_t t = top.load(std::memory_order_acquire);
+    int64_t b = bottom.load(std::memory_order_acquire);
+    return b > t ? static_cast<size_t>(b - t) : 0;
+}
+
+ThreadPool::ThreadPool(size_t threads)
+    : injectedCount(0), idleCount(0), searchingCount(0), stopping(false) {
+    threads = std::max<size_t>(threads, 1);
+    for (size_t i = 0; i < threads; ++i) {
+        workers.emplace_back(new Worker());
+        workers.back()->seed = static_cast<uint32_t>(i * 2654435761u + 1);
+    }
+    for (size_t i = 0; i < threads; ++i) {
+        workers[i]->thread = std::thread([this, i] { run(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    stopping.store(true, std::memory_order_seq_cst);
+
+    // Wake every parked worker; they drain what is left and exit
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        searchingCount.fetch_add(idleWorkers.size(), std::memory_order_seq_cst);
+        idleCount.store(0, std::memory_order_relaxed);
+        idleWorkers.clear();
+    }
+    for (auto& worker : workers) {
+        {
+            std::lock_guard<std::mutex> lock(worker->parkMutex);
+            worker->notified = true;
+        }
+        worker->parkCondition.notify_one();
+    }
+
+    for (auto& worker : workers) {
+        worker->thread.join();
+    }
+    for (Task* task : injected) {
+        delete task;
+    }
+}
+
+void ThreadPool::submit(Task* task) {
+    if (currentPool == this) {
+        // Work spawned by a worker stays local until someone steals it
+        workers[currentIndex]->deque.push(task);
+    } else {
+        std::lock_guard<std::mutex> lock(injectMutex);
+        injected.push_back(task);
+        injectedCount.store(injected.size(), std::memory_order_relaxed);
+    }
+
+    // A worker that is already searching will pick the task up; otherwise
+    // wake one sleeper. Pairs with the fence in park().
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (searchingCount.load(std::memory_order_seq_cst) == 0 && idleCount.load(std::memory_order_seq_cst) > 0) {
+        unparkOne();
+    }
+}
+
+void ThreadPool::run(size_t index) {
+    currentPool = this;
+    currentIndex = index;
+
+    bool searching = false;
+    while (true) {
+        Task* task = workers[index]->deque.pop();
+        if (task == nullptr) {
+            if (!searching) {
+                searching = true;
+                searchingCount.fetch_add(1, std::memory_order_seq_cst);
+            }
+            task = findTask(index);
+        }
+
+        if (task != nullptr) {
+            // The last searcher to find work hands the search on, so queued
+            // tasks keep spreading to idle workers
+            if (searching) {
+                searching = false;
+                if (searchingCount.fetch_sub(1, std::memory_order_seq_cst) == 1 && hasWork()) {
+                    unparkOne();
+                }
+            }
+            std::unique_ptr<Task> owned(task);
+            (*owned)();
+            continue;
+        }
+
+        if (stopping.load(std::memory_order_acquire) && !hasWork()) {
+            if (searching) {
+                searchingCount.fetch_sub(1, std::memory_order_seq_cst);
+            }
+            return;
+        }
+        park(index, searching);
+    }
+}
+
+ThreadPool::Task* ThreadPool::findTask(size_t index) {
+    if (Task* task = takeInjected(index)) {
+        return task;
+    }
+    return steal(index);
+}
+
+ThreadPool::Task* ThreadPool::takeInjected(size_t index) {
+    if (injectedCount.load(std::memory_order_relaxed) == 0) {
+        return nullptr;
+    }
+
+    // Take a fair share in one lock acquisition; the surplus goes on this
+    // worker's deque, where other workers can steal it
+    std::lock_guard<std::mutex> lock(injectMutex);
+    if (injected.empty()) {
+        return nullptr;
+    }
+    size_t share = (injected.size() + workers.size() - 1) / workers.size();
+    size_t count = std::min(share, MAX_INJECTED_BATCH);
+
+    Task* first = injected.front();
+    injected.pop_front();
+    for (size_t i = 1; i < count; ++i) {
+        workers[index]->deque.push(injected.front());
+        injected.pop_front();
+    }
+    injectedCount.store(injected.size(), std::memory_order_relaxed);
+    return first;
+}
+
+ThreadPool::Task* ThreadPool::steal(size_t index) {
+    // Start at a random victim so thieves don't all hit the same deque
+    Worker& self = *workers[index];
+    self.seed = self.seed * 1664525u + 1013904223u;
+    size_t count = workers.size();
+    size_t start = self.seed % count;
+    for (size_t i = 0; i < count; ++i) {
+        size_t victim = (start + i) % count;
+        if (victim == index) {
+            continue;
+        }
+        if (Task* task = workers[victim]->deque.steal()) {
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+size_t ThreadPool::getQueueDepth() const {
+    size_t depth = injectedCount.load(std::memory_order_relaxed);
+    for (const auto& worker : workers) {
+        depth += worker->deque.size();
+    }
+    return depth;
+}
+
+bool ThreadPool::hasWork() const {
+    if (injectedCount.load(std::memory_order_seq_cst) > 0) {
+        return true;
+    }
+    for (const auto& worker : workers) {
+        if (!worker->deque.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::park(size_t index, bool& searching) {
+    Worker& self = *workers[index];
+
+    // Register as idle before leaving the searching state, then look once
+    // more: a submitter either sees this worker idle and wakes it, or its
+    // task is visible to the re-check below
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        idleWorkers.push_back(index);
+        idleCount.fetch_add(1, std::memory_order_seq_cst);
+    }
+    if (searching) {
+        searching = false;
+        searchingCount.fetch_sub(1, std::memory_order_seq_cst);
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (hasWork() || stopping.load(std::memory_order_seq_cst)) {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        auto it = std::find(idleWorkers.begin(), idleWorkers.end(), index);
+        if (it != idleWorkers.end()) {
+            idleWorkers.erase(it);
+            idleCount.fetch_sub(1, std::memory_order_seq_cst);
+            return;
+        }
+        // Already chosen by unparkOne; fall through and consume the wakeup
+    }
+
+    std::unique_lock<std::mutex> lock(self.parkMutex);
+    self.parkCondition.wait(lock, [&self] { return self.notified; });
+    self.notified = false;
+
+    // The waker counted this worker as searching on its behalf
+    searching = true;
+}
+
+void ThreadPool::unparkOne() {
+    size_t index;
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        if (idleWorkers.empty()) {
+            return;
+        }
+        index = idleWorkers.back();
+        idleWorkers.pop_back();
+        idleCount.fetch_sub(1, std::memory_order_seq_cst);
+        searchingCount.fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    Worker& worker = *workers[index];
+    {
+        std::lock_guard<std::mutex> lock(worker.parkMutex);
+        worker.notified = true;
+    }
+    worker.parkCondition.notify_one();
+}
@@ -0,0 +1,111 @@
+// src/server/ThreadPool.h
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Work-stealing thread pool. Each worker owns a lock-free deque: it pushes
+// and pops at the bottom, idle workers steal from the top. Tasks submitted
+// from outside the pool (the event loop) go through a shared injection
+// queue that workers drain in batches into their own deques.
+//
+// Idle workers park individually. A submission wakes at most one, and only
+// when no other worker is already out looking for work, so a burst of tasks
+// does not wake every thread at once.
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(size_t threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    template<class F>
+    void enqueue(F&& task) {
+        if (stopping.load(std::memory_order_acquire)) {
+            throw std::runtime_error("enqueue on stopped ThreadPool");
+        }
+        submit(new Task(std::forward<F>(task)));
+    }
+
+    size_t getThreadCount() const { return workers.size(); }
+
+    // Tasks waiting to run, approximate while workers are busy
+    size_t getQueueDepth() const;
+
+private:
+    // Chase-Lev deque (Le et al., "Correct and Efficient Work-Stealing for
+    // Weak Memory Models"). Only the owning worker calls push and pop.
+    class WorkDeque {
+    public:
+        WorkDeque();
+        ~WorkDeque();
+
+        void push(Task* task);
+        Task* pop();
+        Task* steal();
+        bool empty() const;
+        size_t size() const;
+
+    private:
+        struct Buffer {
+            size_t capacity;
+            std::unique_ptr<std::atomic<Task*>[]> slots;
+
+            explicit Buffer(size_t size) : capacity(size), slots(new std::atomic<Task*>[size]) {}
+            Task* get(int64_t i) const { return slots[i & (capacity - 1)].load(std::memory_order_acquire); }
+            void put(int64_t i, Task* task) { slots[i & (capacity - 1)].store(task, std::memory_order_release); }
+        };
+
+        Buffer* grow(Buffer* buffer, int64_t bottom, int64_t top);
+
+        alignas(64) std::atomic<int64_t> top;
+        alignas(64) std::atomic<int64_t> bottom;
+        std::atomic<Buffer*> buffer;
+
+        // Outgrown buffers may still be read by a thief; freed with the deque
+        std::vector<std::unique_ptr<Buffer>> retired;
+    };
+
+    struct Worker {
+        WorkDeque deque;
+        std::thread thread;
+        std::mutex parkMutex;
+        std::condition_variable parkCondition;
+        bool notified = false;
+        uint32_t seed = 0;
+    };
+
+    void submit(Task* task);
+    void run(size_t index);
+    Task* findTask(size_t index);
+    Task* takeInjected(size_t index);
+    Task* steal(size_t index);
+    bool hasWork() const;
+    void park(size_t index, bool& searching);
+    void unparkOne();
+
+    static constexpr size_t MAX_INJECTED_BATCH = 32;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    std::mutex injectMutex;
+    std::deque<Task*> injected;
+    std::atomic<size_t> injectedCount;
+
+    std::mutex idleMutex;
+    std::vector<size_t> idleWorkers;
+    std::atomic<size_t> idleCount;
+    std::atomic<size_t> searchingCount;     // Workers looking for work, not yet parked
+
+    std::atomic<bool> stopping;
+};
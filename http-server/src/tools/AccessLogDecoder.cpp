@@ -0,0 +1,161 @@
+// src/tools/AccessLogDecoder.cpp
+// Converts binary access logs written by the server to text, CSV, or the
+// combined log format.
+#include "../utils/AccessLog.h"
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+enum class OutputFormat {
+    TEXT,
+    CSV,
+    COMBINED
+};
+
+static void printHelp() {
+    std::cout << "Usage: accesslog_decode [options] <file>...\n";
+    std::cout << "Options:\n";
+    std::cout << "  --format=<text|csv|combined>   Output format (default: text)\n";
+    std::cout << "  --help                         Show this help message\n";
+}
+
+static std::string orDash(std::string_view field) {
+    return field.empty() ? "-" : std::string(field);
+}
+
+static std::string csvField(std::string_view field) {
+    std::string out = "\"";
+    for (char c : field) {
+        if (c == '"') {
+            out += '"';
+        }
+        out += c;
+    }
+    out += '"';
+    return out;
+}
+
+// Quoted fields in the combined format escape quotes and backslashes
+static std::string combinedField(std::string_view field) {
+    if (field.empty()) {
+        return "-";
+    }
+    std::string out;
+    for (char c : field) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += c;
+    }
+    return out;
+}
+
+static void printEntry(const AccessLogEntry& entry, OutputFormat format) {
+    time_t seconds = static_cast<time_t>(entry.timeMicros / 1000000);
+    unsigned micros = static_cast<unsigned>(entry.timeMicros % 1000000);
+    struct tm local;
+    localtime_r(&seconds, &local);
+    char timeBuffer[64];
+
+    switch (format) {
+        case OutputFormat::TEXT: {
+            strftime(timeBuffer, sizeof(timeBuffer), "%Y-%m-%d %H:%M:%S", &local);
+            std::printf("%s.%06u %s %s %s %s %u %llu %.3fms\n", timeBuffer, micros,
+                        orDash(entry.clientIP).c_str(), orDash(entry.method).c_str(),
+                        orDash(entry.path).c_str(), orDash(entry.version).c_str(), entry.status,
+                        static_cast<unsigned long long>(entry.bytes), entry.latencyMicros / 1000.0);
+            break;
+        }
+        case OutputFormat::CSV: {
+            strftime(timeBuffer, sizeof(timeBuffer), "%Y-%m-%dT%H:%M:%S", &local);
+            std::printf("%s.%06u,%s,%s,%s,%s,%u,%llu,%u,%s,%s\n", timeBuffer, micros,
+                        csvField(entry.clientIP).c_str(), csvField(entry.method).c_str(),
+                        csvField(entry.path).c_str(), csvField(entry.version).c_str(), entry.status,
+                        static_cast<unsigned long long>(entry.bytes), entry.latencyMicros,
+                        csvField(entry.referer).c_str(), csvField(entry.userAgent).c_str());
+            break;
+        }
+        case OutputFormat::COMBINED: {
+            strftime(timeBuffer, sizeof(timeBuffer), "%d/%b/%Y:%H:%M:%S %z", &local);
+            std::string request = entry.method.empty()
+                ? "-"
+                : combinedField(entry.method) + " " + combinedField(entry.path) + " " + combinedField(entry.version);
+            std::printf("%s - - [%s] \"%s\" %u %llu \"%s\" \"%s\"\n", orDash(entry.clientIP).c_str(),
+                        timeBuffer, request.c_str(), entry.status,
+                        static_cast<unsigned long long>(entry.bytes),
+                        combinedField(entry.referer).c_str(), combinedField(entry.userAgent).c_str());
+            break;
+        }
+    }
+}
+
+static bool decodeFile(const std::string& path, OutputFormat format) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Cannot open " << path << "\n";
+        return false;
+    }
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (!AccessLog::checkFileHeader(data.data(), data.size())) {
+        std::cerr << path << ": not an access log\n";
+        return false;
+    }
+
+    size_t offset = AccessLog::FILE_HEADER_SIZE;
+    while (offset < data.size()) {
+        AccessLogEntry entry;
+        size_t length = AccessLog::decode(data.data() + offset, data.size() - offset, entry);
+        if (length == 0) {
+            // A record cut short by a crash or a copy taken mid-write
+            std::cerr << path << ": stopping at malformed record at offset " << offset << "\n";
+            return false;
+        }
+        printEntry(entry, format);
+        offset += length;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    OutputFormat format = OutputFormat::TEXT;
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printHelp();
+            return 0;
+        } else if (arg.find("--format=") == 0) {
+            std::string name = arg.substr(9);
+            if (name == "text") format = OutputFormat::TEXT;
+            else if (name == "csv") format = OutputFormat::CSV;
+            else if (name == "combined") format = OutputFormat::COMBINED;
+            else {
+                std::cerr << "Unknown format: " << name << "\n";
+                return 1;
+            }
+        } else {
+            files.push_back(arg);
+        }
+    }
+
+    if (files.empty()) {
+        printHelp();
+        return 1;
+    }
+
+    if (format == OutputFormat::CSV) {
+        std::printf("time,client_ip,method,path,version,status,bytes,latency_us,referer,user_agent\n");
+    }
+
+    bool ok = true;
+    for (const auto& path : files) {
+        ok = decodeFile(path, format) && ok;
+    }
+    return ok ? 0 : 1;
+}
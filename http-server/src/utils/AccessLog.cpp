@@ -0,0 +1,276 @@
+// src/utils/AccessLog.cpp
+#include "AccessLog.h"
+#include "Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+namespace {
+
+// Flush early once a buffer holds this much
+constexpr size_t SHARD_FLUSH_SIZE = 64 * 1024;
+constexpr size_t FIXED_RECORD_SIZE = 4 + 8 + 4 + 8 + 2 + 3 + 6;
+
+template <typename T>
+void putInt(std::string& out, T value) {
+    char bytes[sizeof(T)];
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        bytes[i] = static_cast<char>((static_cast<uint64_t>(value) >> (8 * i)) & 0xff);
+    }
+    out.append(bytes, sizeof(T));
+}
+
+template <typename T>
+T getInt(const char* data) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(data[i])) << (8 * i);
+    }
+    return static_cast<T>(value);
+}
+
+std::string_view clip(std::string_view field, size_t limit) {
+    return field.substr(0, std::min(field.size(), limit));
+}
+
+} // namespace
+
+AccessLog::AccessLog(const std::string& filePath, size_t maxSize, size_t fileCount, size_t shardCount)
+    : path(filePath), maxFileSize(maxSize), maxFiles(std::max<size_t>(1, fileCount)), nextShard(0),
+      fd(-1), fileSize(0), stopping(false), flushRequested(false) {
+    for (size_t i = 0; i < std::max<size_t>(1, shardCount); ++i) {
+        shards.push_back(std::make_unique<Shard>());
+        shards.back()->buffer.reserve(SHARD_FLUSH_SIZE);
+    }
+}
+
+AccessLog::~AccessLog() {
+    if (writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        writer.join();
+    }
+    if (fd >= 0) {
+        ::close(fd);
+    }
+}
+
+bool AccessLog::start() {
+    if (!openFile()) {
+        return false;
+    }
+    writer = std::thread(&AccessLog::writeLoop, this);
+    return true;
+}
+
+AccessLog::Shard& AccessLog::localShard() {
+    // Threads are spread over the shards round robin, once each
+    thread_local size_t index = nextShard.fetch_add(1, std::memory_order_relaxed);
+    return *shards[index % shards.size()];
+}
+
+void AccessLog::record(const AccessLogEntry& entry) {
+    Shard& shard = localShard();
+    bool full;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        encode(shard.buffer, entry);
+        full = shard.buffer.size() >= SHARD_FLUSH_SIZE;
+    }
+    if (full && !flushRequested.exchange(true, std::memory_order_relaxed)) {
+        wake.notify_one();
+    }
+}
+
+void AccessLog::writeLoop() {
+    std::vector<std::string> spare(shards.size());
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    while (!stopping) {
+        wake.wait_for(lock, std::chrono::seconds(1), [this]() {
+            return stopping || flushRequested.load(std::memory_order_relaxed);
+        });
+        flushRequested.store(false, std::memory_order_relaxed);
+        lock.unlock();
+        flush(spare);
+        lock.lock();
+    }
+    lock.unlock();
+    flush(spare);
+}
+
+void AccessLog::flush(std::vector<std::string>& spare) {
+    // Swap every buffer out under its lock, then write them all with one call
+    size_t total = 0;
+    for (size_t i = 0; i < shards.size(); ++i) {
+        spare[i].clear();
+        {
+            std::lock_guard<std::mutex> lock(shards[i]->mutex);
+            shards[i]->buffer.swap(spare[i]);
+        }
+        total += spare[i].size();
+    }
+    if (total == 0) {
+        return;
+    }
+
+    if (maxFileSize > 0 && fileSize > FILE_HEADER_SIZE && fileSize + total > maxFileSize) {
+        rotate();
+    }
+    if (fd < 0) {
+        return;
+    }
+
+    std::vector<iovec> iov;
+    for (auto& buffer : spare) {
+        if (!buffer.empty()) {
+            iov.push_back({&buffer[0], buffer.size()});
+        }
+    }
+
+    size_t index = 0;
+    while (index < iov.size()) {
+        ssize_t written = ::writev(fd, &iov[index], static_cast<int>(std::min<size_t>(iov.size() - index, IOV_MAX)));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            Logger::error("Failed to write access log: " + std::string(strerror(errno)));
+            return;
+        }
+        fileSize += static_cast<size_t>(written);
+        size_t remaining = static_cast<size_t>(written);
+        while (index < iov.size() && remaining >= iov[index].iov_len) {
+            remaining -= iov[index].iov_len;
+            ++index;
+        }
+        if (remaining > 0) {
+            iov[index].iov_base = static_cast<char*>(iov[index].iov_base) + remaining;
+            iov[index].iov_len -= remaining;
+        }
+    }
+}
+
+bool AccessLog::openFile() {
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        Logger::error("Cannot open access log " + path + ": " + strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    fileSize = fstat(fd, &st) == 0 ? static_cast<size_t>(st.st_size) : 0;
+    if (fileSize == 0) {
+        std::string header;
+        encodeFileHeader(header);
+        if (::write(fd, header.data(), header.size()) == static_cast<ssize_t>(header.size())) {
+            fileSize = header.size();
+        }
+    }
+    return true;
+}
+
+void AccessLog::rotate() {
+    ::close(fd);
+    fd = -1;
+
+    // access.log -> access.log.1 -> ... -> access.log.<maxFiles>, oldest dropped
+    for (size_t i = maxFiles; i > 1; --i) {
+        std::string from = path + "." + std::to_string(i - 1);
+        std::string to = path + "." + std::to_string(i);
+        ::rename(from.c_str(), to.c_str());
+    }
+    ::rename(path.c_str(), (path + ".1").c_str());
+
+    openFile();
+}
+
+void AccessLog::encodeFileHeader(std::string& out) {
+    out.append("HSAL", 4);
+    putInt<uint16_t>(out, FORMAT_VERSION);
+    putInt<uint16_t>(out, 0);
+}
+
+bool AccessLog::checkFileHeader(const char* data, size_t size) {
+    return size >= FILE_HEADER_SIZE && memcmp(data, "HSAL", 4) == 0 &&
+           getInt<uint16_t>(data + 4) == FORMAT_VERSION;
+}
+
+void AccessLog::encode(std::string& out, const AccessLogEntry& entry) {
+    std::string_view method = clip(entry.method, 255);
+    std::string_view version = clip(entry.version, 255);
+    std::string_view clientIP = clip(entry.clientIP, 255);
+    std::string_view path = clip(entry.path, MAX_FIELD_LENGTH);
+    std::string_view referer = clip(entry.referer, MAX_FIELD_LENGTH);
+    std::string_view userAgent = clip(entry.userAgent, MAX_FIELD_LENGTH);
+
+    size_t length = FIXED_RECORD_SIZE + method.size() + version.size() + clientIP.size() +
+                    path.size() + referer.size() + userAgent.size();
+    out.reserve(out.size() + length);
+
+    putInt<uint32_t>(out, static_cast<uint32_t>(length));
+    putInt<uint64_t>(out, entry.timeMicros);
+    putInt<uint32_t>(out, entry.latencyMicros);
+    putInt<uint64_t>(out, entry.bytes);
+    putInt<uint16_t>(out, entry.status);
+    putInt<uint8_t>(out, static_cast<uint8_t>(method.size()));
+    putInt<uint8_t>(out, static_cast<uint8_t>(version.size()));
+    putInt<uint8_t>(out, static_cast<uint8_t>(clientIP.size()));
+    putInt<uint16_t>(out, static_cast<uint16_t>(path.size()));
+    putInt<uint16_t>(out, static_cast<uint16_t>(referer.size()));
+    putInt<uint16_t>(out, static_cast<uint16_t>(userAgent.size()));
+    out.append(method);
+    out.append(version);
+    out.append(clientIP);
+    out.append(path);
+    out.append(referer);
+    out.append(userAgent);
+}
+
+size_t AccessLog::decode(const char* data, size_t size, AccessLogEntry& entry) {
+    if (size < FIXED_RECORD_SIZE) {
+        return 0;
+    }
+    size_t length = getInt<uint32_t>(data);
+    if (length < FIXED_RECORD_SIZE || length > size) {
+        return 0;
+    }
+
+    entry.timeMicros = getInt<uint64_t>(data + 4);
+    entry.latencyMicros = getInt<uint32_t>(data + 12);
+    entry.bytes = getInt<uint64_t>(data + 16);
+    entry.status = getInt<uint16_t>(data + 24);
+    size_t methodLength = getInt<uint8_t>(data + 26);
+    size_t versionLength = getInt<uint8_t>(data + 27);
+    size_t ipLength = getInt<uint8_t>(data + 28);
+    size_t pathLength = getInt<uint16_t>(data + 29);
+    size_t refererLength = getInt<uint16_t>(data + 31);
+    size_t agentLength = getInt<uint16_t>(data + 33);
+
+    if (FIXED_RECORD_SIZE + methodLength + versionLength + ipLength + pathLength +
+        refererLength + agentLength != length) {
+        return 0;
+    }
+
+    const char* p = data + FIXED_RECORD_SIZE;
+    auto take = [&p](size_t n) {
+        std::string_view field(p, n);
+        p += n;
+        return field;
+    };
+    entry.method = take(methodLength);
+    entry.version = take(versionLength);
+    entry.clientIP = take(ipLength);
+    entry.path = take(pathLength);
+    entry.referer = take(refererLength);
+    entry.userAgent = take(agentLength);
+    return length;
+}
@@ -0,0 +1,97 @@
+// src/utils/AccessLog.h
+#pragma once
+#include <string>
+#include <string_view>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// One access log record. Decoded records point into the buffer they were
+// decoded from.
+struct AccessLogEntry {
+    uint64_t timeMicros = 0;        // Unix time the response was ready
+    uint32_t latencyMicros = 0;     // From the request being framed to the response being ready
+    uint64_t bytes = 0;             // Body bytes sent
+    uint16_t status = 0;
+    std::string_view method;
+    std::string_view path;
+    std::string_view version;
+    std::string_view clientIP;
+    std::string_view referer;
+    std::string_view userAgent;
+};
+
+// Append-only binary access log, rotated by size. Request threads encode
+// records into one of several independently locked buffers; a background
+// thread writes the buffers out once a second, or sooner when one fills,
+// so the request path does no formatting and no syscalls.
+//
+// File format (little-endian): an 8-byte header "HSAL", u16 version,
+// u16 reserved; then records of
+//     u32 record length (including this field)
+//     u64 time (unix microseconds), u32 latency (microseconds),
+//     u64 body bytes, u16 status,
+//     u8 method length, u8 version length, u8 client IP length,
+//     u16 path length, u16 referer length, u16 user agent length,
+//     followed by the strings in that order.
+// Records are in order per buffer, not globally.
+class AccessLog {
+private:
+    struct Shard {
+        std::mutex mutex;
+        std::string buffer;
+    };
+
+    std::string path;
+    size_t maxFileSize;
+    size_t maxFiles;
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::atomic<size_t> nextShard;
+
+    // Writer thread
+    int fd;
+    size_t fileSize;
+    std::thread writer;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    bool stopping;
+    std::atomic<bool> flushRequested;
+
+    Shard& localShard();
+    void writeLoop();
+    void flush(std::vector<std::string>& spare);
+    bool openFile();
+    void rotate();
+
+public:
+    static constexpr uint16_t FORMAT_VERSION = 1;
+    static constexpr size_t FILE_HEADER_SIZE = 8;
+    static constexpr size_t MAX_FIELD_LENGTH = 4096;     // Longer strings are truncated
+
+    AccessLog(const std::string& filePath, size_t maxFileSize, size_t maxFiles, size_t shardCount = 16);
+    ~AccessLog();
+
+    AccessLog(const AccessLog&) = delete;
+    AccessLog& operator=(const AccessLog&) = delete;
+
+    // Opens the file and starts the writer. Returns false if the file
+    // cannot be opened.
+    bool start();
+
+    // Thread-safe; copies the entry into a buffer and returns
+    void record(const AccessLogEntry& entry);
+
+    // Format shared with the decoder
+    static void encodeFileHeader(std::string& out);
+    static bool checkFileHeader(const char* data, size_t size);
+    static void encode(std::string& out, const AccessLogEntry& entry);
+    // Decodes the record at the start of data. Returns its length, or 0 if
+    // data holds only part of a record or the record is malformed.
+    static size_t decode(const char* data, size_t size, AccessLogEntry& entry);
+};
@@ -0,0 +1,65 @@
+// src/utils/Arena.cpp
+#include "Arena.h"
+#include <atomic>
+#include <memory>
+
+namespace {
+
+std::atomic<uint64_t> overflowCount{0};
+
+// Upstream of every arena: the global heap, counting each trip to it
+class OverflowResource : public std::pmr::memory_resource {
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        overflowCount.fetch_add(1, std::memory_order_relaxed);
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+OverflowResource overflowResource;
+
+struct ThreadArena {
+    std::unique_ptr<std::max_align_t[]> buffer;
+    std::pmr::monotonic_buffer_resource resource;
+    int depth = 0;
+
+    ThreadArena()
+        : buffer(new std::max_align_t[RequestArena::BUFFER_SIZE / sizeof(std::max_align_t)]),
+          resource(buffer.get(), RequestArena::BUFFER_SIZE, &overflowResource) {}
+};
+
+ThreadArena& threadArena() {
+    thread_local ThreadArena arena;
+    return arena;
+}
+
+} // namespace
+
+std::pmr::memory_resource* RequestArena::current() {
+    ThreadArena& arena = threadArena();
+    return arena.depth > 0 ? &arena.resource : std::pmr::get_default_resource();
+}
+
+uint64_t RequestArena::getOverflowCount() {
+    return overflowCount.load(std::memory_order_relaxed);
+}
+
+ArenaScope::ArenaScope() {
+    threadArena().depth++;
+}
+
+ArenaScope::~ArenaScope() {
+    ThreadArena& arena = threadArena();
+    if (--arena.depth == 0) {
+        // Back to the start of the buffer; anything spilled is freed
+        arena.resource.release();
+    }
+}
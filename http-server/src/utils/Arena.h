@@ -0,0 +1,36 @@
+// src/utils/Arena.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+// Per-thread monotonic arena for objects that live for a single request:
+// response headers, body segment lists and handler scratch containers.
+// Allocation is a pointer bump into a buffer the thread keeps for its
+// lifetime, and everything is released at once when the request is done.
+// Requests that outgrow the buffer spill over to the global heap until the
+// arena is next reset.
+class RequestArena {
+public:
+    static constexpr size_t BUFFER_SIZE = 16 * 1024;
+
+    // The calling thread's arena inside an ArenaScope, otherwise the
+    // default resource, so code running outside a request never holds
+    // arena memory that outlives it
+    static std::pmr::memory_resource* current();
+
+    // Allocations that did not fit in a thread's buffer, over all threads
+    static uint64_t getOverflowCount();
+};
+
+// Makes the thread's arena current for as long as it lives and releases
+// everything allocated from it when the outermost scope ends. Objects that
+// allocate from the arena must be destroyed before their scope is.
+class ArenaScope {
+public:
+    ArenaScope();
+    ~ArenaScope();
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+};
@@ -0,0 +1,242 @@
+// src/utils/FileCache.cpp
+#include "FileCache.h"
+#include "Logger.h"
+#include <filesystem>
+#include <functional>
+#include <sys/inotify.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+#include <climits>
+
+namespace fs = std::filesystem;
+
+FileCache::FileCache(size_t maxBytes, size_t maxFileSize, size_t shardCount)
+    : maxEntrySize(maxFileSize), generation(0), hits(0), misses(0),
+      inotifyFd(-1), stopFd(-1) {
+    if (shardCount == 0) {
+        shardCount = 1;
+    }
+    for (size_t i = 0; i < shardCount; ++i) {
+        shards.push_back(std::make_unique<Shard>());
+    }
+    maxShardBytes = maxBytes / shardCount;
+}
+
+FileCache::~FileCache() {
+    if (watcher.joinable()) {
+        uint64_t one = 1;
+        ssize_t n = ::write(stopFd, &one, sizeof(one));
+        (void)n;
+        watcher.join();
+    }
+    if (inotifyFd >= 0) ::close(inotifyFd);
+    if (stopFd >= 0) ::close(stopFd);
+}
+
+std::string FileCache::normalizeKey(const std::string& path) {
+    // A directory keeps its trailing slash through lexically_normal; drop it
+    // so "root/" and "root" watch under the same key that files are joined to
+    std::string key = fs::path(path).lexically_normal().string();
+    while (key.size() > 1 && key.back() == '/') {
+        key.pop_back();
+    }
+    return key;
+}
+
+FileCache::Shard& FileCache::shardFor(const std::string& path) {
+    return *shards[std::hash<std::string>{}(path) % shards.size()];
+}
+
+std::shared_ptr<const CachedFile> FileCache::get(const std::string& path) {
+    Shard& shard = shardFor(path);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.index.find(path);
+    if (it == shard.index.end()) {
+        misses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    // Move to the front of the LRU list
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    hits.fetch_add(1, std::memory_order_relaxed);
+    return *it->second;
+}
+
+void FileCache::put(std::shared_ptr<const CachedFile> entry, uint64_t loadGeneration) {
+    if (!entry || entry->size > maxEntrySize || entry->size > maxShardBytes) {
+        return;
+    }
+
+    Shard& shard = shardFor(entry->path);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    // Checked under the shard lock: invalidate() bumps the generation before
+    // taking it, so a stale load can never slip in after its invalidation
+    if (generation.load(std::memory_order_acquire) != loadGeneration) {
+        return;
+    }
+
+    removeLocked(shard, entry->path);
+
+    // Evict least recently used entries until the new one fits
+    while (!shard.lru.empty() && shard.bytes + entry->size > maxShardBytes) {
+        removeLocked(shard, shard.lru.back()->path);
+    }
+
+    shard.bytes += entry->size;
+    shard.lru.push_front(entry);
+    shard.index[entry->path] = shard.lru.begin();
+}
+
+void FileCache::removeLocked(Shard& shard, const std::string& path) {
+    auto it = shard.index.find(path);
+    if (it == shard.index.end()) {
+        return;
+    }
+    shard.bytes -= (*it->second)->size;
+    shard.lru.erase(it->second);
+    shard.index.erase(it);
+}
+
+void FileCache::invalidate(const std::string& path) {
+    generation.fetch_add(1, std::memory_order_acq_rel);
+
+    Shard& shard = shardFor(path);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    removeLocked(shard, path);
+}
+
+void FileCache::invalidatePrefix(const std::string& prefix) {
+    generation.fetch_add(1, std::memory_order_acq_rel);
+
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        for (auto it = shard->lru.begin(); it != shard->lru.end();) {
+            const std::string& path = (*it)->path;
+            ++it;
+            if (path.compare(0, prefix.size(), prefix) == 0) {
+                removeLocked(*shard, path);
+            }
+        }
+    }
+}
+
+void FileCache::clear() {
+    generation.fetch_add(1, std::memory_order_acq_rel);
+
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->lru.clear();
+        shard->index.clear();
+        shard->bytes = 0;
+    }
+}
+
+bool FileCache::watch(const std::string& root) {
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (inotifyFd < 0 || stopFd < 0) {
+        return false;
+    }
+
+    std::string normalizedRoot = normalizeKey(root);
+    addWatch(normalizedRoot);
+    try {
+        for (const auto& entry : fs::recursive_directory_iterator(normalizedRoot)) {
+            if (entry.is_directory()) {
+                addWatch(normalizeKey(entry.path().string()));
+            }
+        }
+    } catch (...) {
+        // Unreadable subdirectories simply aren't watched
+    }
+
+    if (watchedDirs.empty()) {
+        return false;
+    }
+
+    watcher = std::thread(&FileCache::watchLoop, this);
+    return true;
+}
+
+void FileCache::addWatch(const std::string& dir) {
+    const uint32_t mask = IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_CREATE | IN_DELETE |
+                          IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF;
+    int wd = inotify_add_watch(inotifyFd, dir.c_str(), mask);
+    if (wd < 0) {
+        Logger::warning("Cannot watch directory for cache invalidation: " + dir);
+        return;
+    }
+    watchedDirs[wd] = dir;
+}
+
+void FileCache::watchLoop() {
+    alignas(inotify_event) char buffer[16 * (sizeof(inotify_event) + NAME_MAX + 1)];
+    pollfd fds[2] = {{inotifyFd, POLLIN, 0}, {stopFd, POLLIN, 0}};
+
+    while (true) {
+        if (poll(fds, 2, -1) < 0) {
+            continue;
+        }
+        if (fds[1].revents & POLLIN) {
+            return;
+        }
+
+        ssize_t length;
+        while ((length = ::read(inotifyFd, buffer, sizeof(buffer))) > 0) {
+            handleEvents(buffer, length);
+        }
+    }
+}
+
+void FileCache::handleEvents(const char* buffer, ssize_t length) {
+    for (const char* ptr = buffer; ptr < buffer + length;) {
+        const inotify_event* event = reinterpret_cast<const inotify_event*>(ptr);
+        ptr += sizeof(inotify_event) + event->len;
+
+        if (event->mask & IN_Q_OVERFLOW) {
+            // Events were lost, nothing in the cache can be trusted
+            clear();
+            continue;
+        }
+
+        auto it = watchedDirs.find(event->wd);
+        if (it == watchedDirs.end()) {
+            continue;
+        }
+        const std::string dir = it->second;
+
+        if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) {
+            invalidatePrefix(dir + "/");
+            if (event->mask & IN_IGNORED) {
+                watchedDirs.erase(it);
+            }
+            continue;
+        }
+
+        if (event->len == 0) {
+            continue;
+        }
+
+        // Joined the way request paths are, so it matches their cache keys
+        std::string path = normalizeKey(dir + "/" + event->name);
+        if (event->mask & IN_ISDIR) {
+            // A directory appeared or moved: drop anything cached beneath it
+            invalidatePrefix(path + "/");
+            if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                addWatch(path);
+            }
+        } else {
+            invalidate(path);
+
+            // A precompressed sibling changes how its original is served
+            size_t dot = path.find_last_of('.');
+            if (dot != std::string::npos && (path.compare(dot, 3, ".gz") == 0 || path.compare(dot, 3, ".br") == 0)
+                && dot + 3 == path.size()) {
+                invalidate(path.substr(0, dot));
+            }
+        }
+    }
+}
@@ -0,0 +1,96 @@
+// src/utils/FileCache.h
+#pragma once
+#include <string>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <unordered_map>
+#include <ctime>
+#include <sys/types.h>
+
+// A static file held in memory together with the metadata needed to serve it
+struct CachedFile {
+    std::string path;
+    std::shared_ptr<const std::string> content;
+    std::string mimeType;
+    size_t size;
+    time_t modifiedTime;
+    ino_t inode;
+
+    // Precompressed siblings (foo.css.gz, foo.css.br) present at load time
+    bool hasGzipSibling = false;
+    bool hasBrotliSibling = false;
+
+    // Compressed variants produced on first request for an encoding. They
+    // live and die with the entry but are not counted against the budget.
+    mutable std::mutex variantMutex;
+    mutable std::shared_ptr<const std::string> gzipVariant;
+    mutable std::shared_ptr<const std::string> deflateVariant;
+};
+
+// Size-bounded LRU cache of static files keyed by normalized filesystem
+// path. Entries are spread over independently locked shards to keep worker
+// threads from contending on a single mutex, and are invalidated through
+// inotify when anything under the watched root changes.
+class FileCache {
+private:
+    struct Shard {
+        std::mutex mutex;
+        std::list<std::shared_ptr<const CachedFile>> lru;   // Most recent first
+        std::unordered_map<std::string, std::list<std::shared_ptr<const CachedFile>>::iterator> index;
+        size_t bytes = 0;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    size_t maxShardBytes;
+    size_t maxEntrySize;
+
+    // Bumped on every invalidation so a load racing with a change is dropped
+    std::atomic<uint64_t> generation;
+
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> misses;
+
+    // inotify watcher
+    int inotifyFd;
+    int stopFd;
+    std::thread watcher;
+    std::unordered_map<int, std::string> watchedDirs;   // Watcher thread only
+
+    Shard& shardFor(const std::string& path);
+    void removeLocked(Shard& shard, const std::string& path);
+    void addWatch(const std::string& dir);
+    void watchLoop();
+    void handleEvents(const char* buffer, ssize_t length);
+
+public:
+    FileCache(size_t maxBytes, size_t maxFileSize, size_t shardCount = 16);
+    ~FileCache();
+
+    FileCache(const FileCache&) = delete;
+    FileCache& operator=(const FileCache&) = delete;
+
+    // Starts invalidating entries on changes below root. Returns false if
+    // inotify is unavailable, in which case the cache must not be used.
+    bool watch(const std::string& root);
+
+    std::shared_ptr<const CachedFile> get(const std::string& path);
+
+    // Inserts an entry read while getGeneration() returned loadGeneration;
+    // ignored if anything was invalidated in the meantime.
+    void put(std::shared_ptr<const CachedFile> entry, uint64_t loadGeneration);
+
+    void invalidate(const std::string& path);
+    void invalidatePrefix(const std::string& prefix);
+    void clear();
+
+    bool isCacheable(size_t fileSize) const { return fileSize <= maxEntrySize; }
+    uint64_t getGeneration() const { return generation.load(std::memory_order_acquire); }
+    uint64_t getHits() const { return hits.load(std::memory_order_relaxed); }
+    uint64_t getMisses() const { return misses.load(std::memory_order_relaxed); }
+
+    static std::string normalizeKey(const std::string& path);
+};
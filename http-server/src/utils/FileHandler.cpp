@@ -1,141 +1,188 @@
-// src/utils/FileHandler.cpp
-#include "FileHandler.h"
-#include <iostream>
-#include <stdexcept>
-
-namespace fs = std::filesystem;
-
-bool FileHandler::fileExists(const std::string& path) {
-    try {
-        return fs::exists(path) && fs::is_regular_file(path);
-    } catch (...) {
-        return false;
-    }
-}
-
-std::string FileHandler::readFile(const std::string& path) {
-    std::ifstream file(path, std::ios::binary);
-    if (!file.is_open()) {
-        throw std::runtime_error("Cannot open file: " + path);
-    }
-    
-    std::string content;
-    file.seekg(0, std::ios::end);
-    content.resize(file.tellg());
-    file.seekg(0, std::ios::beg);
-    file.read(&content[0], content.size());
-    file.close();
-    
-    return content;
-}
-
-bool FileHandler::writeFile(const std::string& path, const std::string& content) {
-    std::ofstream file(path, std::ios::binary);
-    if (!file.is_open()) {
-        return false;
-    }
-    
-    file.write(content.c_str(), content.size());
-    file.close();
-    return true;
-}
-
-std::string FileHandler::getMimeType(const std::string& filename) {
-    std::string ext = getFileExtension(filename);
-    
-    static const std::unordered_map<std::string, std::string> mimeTypes = {
-        {".html", "text/html"},
-        {".htm", "text/html"},
-        {".css", "text/css"},
-        {".js", "application/javascript"},
-        {".json", "application/json"},
-        {".png", "image/png"},
-        {".jpg", "image/jpeg"},
-        {".jpeg", "image/jpeg"},
-        {".gif", "image/gif"},
-        {".svg", "image/svg+xml"},
-        {".txt", "text/plain"},
-        {".pdf", "application/pdf"},
-        {".zip", "application/zip"},
-        {".xml", "application/xml"},
-        {".ico", "image/x-icon"}
-    };
-    
-    auto it = mimeTypes.find(ext);
-    if (it != mimeTypes.end()) {
-        return it->second;
-    }
-    return "application/octet-stream";
-}
-
-size_t FileHandler::getFileSize(const std::string& path) {
-    try {
-        return fs::file_size(path);
-    } catch (...) {
-        return 0;
-    }
-}
-
-bool FileHandler::isDirectory(const std::string& path) {
-    try {
-        return fs::is_directory(path);
-    } catch (...) {
-        return false;
-    }
-}
-
-std::vector<std::string> FileHandler::listDirectory(const std::string& path) {
-    std::vector<std::string> files;
-    try {
-        for (const auto& entry : fs::directory_iterator(path)) {
-            std::string filename = entry.path().filename().string();
-            if (entry.is_directory()) {
-                filename += "/";
-            }
-            files.push_back(filename);
-        }
-    } catch (...) {
-        // Return empty vector on error
-    }
-    return files;
-}
-
-bool FileHandler::isPathSafe(const std::string& webRoot, const std::string& requestedPath) {
-    try {
-        fs::path root = fs::absolute(webRoot);
-        fs::path request = fs::absolute(requestedPath);
-        
-        // Check if requested path is within web root
-        auto rootIt = root.begin();
-        auto reqIt = request.begin();
-        
-        while (rootIt != root.end() && reqIt != request.end()) {
-            if (*rootIt != *reqIt) {
-                return false;
-            }
-            ++rootIt;
-            ++reqIt;
-        }
-        
-        // If we've gone through all root components, path is safe
-        return rootIt == root.end();
-    } catch (...) {
-        return false;
-    }
-}
-
-std::string FileHandler::getFileExtension(const std::string& filename) {
-    size_t dotPos = filename.find_last_of('.');
-    if (dotPos != std::string::npos) {
-        return filename.substr(dotPos);
-    }
-    return "";
-}
-
-std::string FileHandler::normalizePath(const std::string& path) {
-    try {
-        return fs::absolute(fs::path(path)).string();
-    } catch (...) {
-        return path;
-    }
+// src/utils/FileHandler.cpp
+#include "FileHandler.h"
+#include "../http/MimeTypes.h"
+#include <iostream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+
+namespace fs = std::filesystem;
+
+bool FileHandler::fileExists(const std::string& path) {
+    try {
+        return fs::exists(path) && fs::is_regular_file(path);
+    } catch (...) {
+        return false;
+    }
+}
+
+std::string FileHandler::readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+    
+    std::string content;
+    file.seekg(0, std::ios::end);
+    content.resize(file.tellg());
+    file.seekg(0, std::ios::beg);
+    file.read(&content[0], content.size());
+    file.close();
+    
+    return content;
+}
+
+FileHandle::~FileHandle() {
+    if (fd >= 0) {
+        ::close(fd);
+    }
+}
+
+std::shared_ptr<FileHandle> FileHandler::openFile(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return nullptr;
+    }
+    
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        ::close(fd);
+        return nullptr;
+    }
+    
+    return std::make_shared<FileHandle>(fd, info);
+}
+
+bool FileHandler::readFile(const FileHandle& file, std::string& content) {
+    content.resize(file.getSize());
+    size_t total = 0;
+    while (total < content.size()) {
+        ssize_t n = pread(file.getFD(), &content[total], content.size() - total, total);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        total += n;
+    }
+    return true;
+}
+
+bool FileHandler::writeFile(const std::string& path, const std::string& content) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    file.write(content.c_str(), content.size());
+    file.close();
+    return true;
+}
+
+std::string FileHandler::getMimeType(const std::string& filename) {
+    return std::string(MimeTypes::forPath(filename));
+}
+
+size_t FileHandler::getFileSize(const std::string& path) {
+    try {
+        return fs::file_size(path);
+    } catch (...) {
+        return 0;
+    }
+}
+
+bool FileHandler::isDirectory(const std::string& path) {
+    try {
+        return fs::is_directory(path);
+    } catch (...) {
+        return false;
+    }
+}
+
+DirectoryReader::DirectoryReader(const std::string& path) {
+    std::error_code ec;
+    it = fs::directory_iterator(path, ec);
+}
+
+bool DirectoryReader::next(DirectoryEntry& entry) {
+    std::error_code ec;
+    if (it == fs::directory_iterator()) {
+        return false;
+    }
+    
+    entry.name = it->path().filename().string();
+    entry.isDirectory = it->is_directory(ec);
+    entry.size = entry.isDirectory ? 0 : static_cast<size_t>(it->file_size(ec));
+    if (ec) {
+        entry.size = 0;
+    }
+    
+    it.increment(ec);
+    if (ec) {
+        it = fs::directory_iterator();
+    }
+    return true;
+}
+
+std::vector<std::string> FileHandler::listDirectory(const std::string& path) {
+    std::vector<std::string> files;
+    try {
+        for (const auto& entry : fs::directory_iterator(path)) {
+            std::string filename = entry.path().filename().string();
+            if (entry.is_directory()) {
+                filename += "/";
+            }
+            files.push_back(filename);
+        }
+    } catch (...) {
+        // Return empty vector on error
+    }
+    return files;
+}
+
+bool FileHandler::isPathSafe(const std::string& webRoot, const std::string& requestedPath) {
+    try {
+        // Compare lexically normalized paths so ".." segments can't climb
+        // out of the root
+        fs::path root = fs::absolute(webRoot).lexically_normal();
+        fs::path request = fs::absolute(requestedPath).lexically_normal();
+        if (!root.has_filename()) {
+            root = root.parent_path();
+        }
+        
+        // Check if requested path is within web root
+        auto rootIt = root.begin();
+        auto reqIt = request.begin();
+        
+        while (rootIt != root.end() && reqIt != request.end()) {
+            if (*rootIt != *reqIt) {
+                return false;
+            }
+            ++rootIt;
+            ++reqIt;
+        }
+        
+        // If we've gone through all root components, path is safe
+        return rootIt == root.end();
+    } catch (...) {
+        return false;
+    }
+}
+
+std::string FileHandler::getFileExtension(const std::string& filename) {
+    size_t dotPos = filename.find_last_of('.');
+    if (dotPos != std::string::npos) {
+        return filename.substr(dotPos);
+    }
+    return "";
+}
+
+std::string FileHandler::normalizePath(const std::string& path) {
+    try {
+        return fs::absolute(fs::path(path)).string();
+    } catch (...) {
+        return path;
+    }
 }
\ No newline at end of file
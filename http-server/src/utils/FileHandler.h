@@ -1,26 +1,67 @@
-// src/utils/FileHandler.h
-#pragma once
-#include <string>
-#include <vector>
-#include <fstream>
-#include <filesystem>
-
-class FileHandler {
-public:
-    static bool fileExists(const std::string& path);
-    static std::string readFile(const std::string& path);
-    static bool writeFile(const std::string& path, const std::string& content);
-    static std::string getMimeType(const std::string& filename);
-    static size_t getFileSize(const std::string& path);
-    
-    // Directory operations
-    static bool isDirectory(const std::string& path);
-    static std::vector<std::string> listDirectory(const std::string& path);
-    
-    // Security
-    static bool isPathSafe(const std::string& webRoot, const std::string& requestedPath);
-    
-    // File utilities
-    static std::string getFileExtension(const std::string& filename);
-    static std::string normalizePath(const std::string& path);
+// src/utils/FileHandler.h
+#pragma once
+#include <string>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include <memory>
+#include <sys/stat.h>
+
+// Read-only file kept open so its contents can be handed to the kernel
+// (sendfile) instead of being copied through userspace. Closed on destruction.
+class FileHandle {
+private:
+    int fd;
+    struct stat info;
+    
+public:
+    FileHandle(int fileFd, const struct stat& fileInfo) : fd(fileFd), info(fileInfo) {}
+    ~FileHandle();
+    
+    FileHandle(const FileHandle&) = delete;
+    FileHandle& operator=(const FileHandle&) = delete;
+    
+    int getFD() const { return fd; }
+    size_t getSize() const { return static_cast<size_t>(info.st_size); }
+    const struct stat& getInfo() const { return info; }
+};
+
+struct DirectoryEntry {
+    std::string name;
+    bool isDirectory;
+    size_t size;
+};
+
+// Walks a directory one entry at a time, so a listing can be sent while
+// it is being read. An unreadable directory simply has no entries.
+class DirectoryReader {
+private:
+    std::filesystem::directory_iterator it;
+    
+public:
+    explicit DirectoryReader(const std::string& path);
+    
+    bool next(DirectoryEntry& entry);
+};
+
+class FileHandler {
+public:
+    static bool fileExists(const std::string& path);
+    static std::string readFile(const std::string& path);
+    static std::shared_ptr<FileHandle> openFile(const std::string& path);
+    static bool readFile(const FileHandle& file, std::string& content);
+    static bool writeFile(const std::string& path, const std::string& content);
+    static std::string getMimeType(const std::string& filename);
+    static size_t getFileSize(const std::string& path);
+    
+    // Directory operations
+    static bool isDirectory(const std::string& path);
+    static std::vector<std::string> listDirectory(const std::string& path);
+    
+    // Security
+    static bool isPathSafe(const std::string& webRoot, const std::string& requestedPath);
+    
+    // File utilities
+    static std::string getFileExtension(const std::string& filename);
+    static std::string normalizePath(const std::string& path);
 };
\ No newline at end of file
@@ -1,88 +1,300 @@
-// src/utils/Logger.cpp
-#include "Logger.h"
-
-std::ofstream Logger::logFile;
-LogLevel Logger::currentLevel = LogLevel::INFO;
-std::mutex Logger::logMutex;
-
-void Logger::init(const std::string& filename, LogLevel level) {
-    std::lock_guard<std::mutex> lock(logMutex);
-    
-    currentLevel = level;
-    
-    if (!filename.empty()) {
-        logFile.open(filename, std::ios::app);
-        if (!logFile.is_open()) {
-            std::cerr << "Warning: Cannot open log file: " << filename << std::endl;
-        }
-    }
-}
-
-void Logger::close() {
-    std::lock_guard<std::mutex> lock(logMutex);
-    if (logFile.is_open()) {
-        logFile.close();
-    }
-}
-
-std::string Logger::levelToString(LogLevel level) {
-    switch (level) {
-        case LogLevel::DEBUG: return "DEBUG";
-        case LogLevel::INFO: return "INFO";
-        case LogLevel::WARNING: return "WARNING";
-        case LogLevel::ERROR: return "ERROR";
-        default: return "UNKNOWN";
-    }
-}
-
-std::string Logger::getCurrentTime() {
-    auto now = std::chrono::system_clock::now();
-    auto time = std::chrono::system_clock::to_time_t(now);
-    
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&time), "%Y-%m-%d %H:%M:%S");
-    return ss.str();
-}
-
-void Logger::debug(const std::string& message) {
-    if (currentLevel <= LogLevel::DEBUG) {
-        log(LogLevel::DEBUG, message);
-    }
-}
-
-void Logger::info(const std::string& message) {
-    if (currentLevel <= LogLevel::INFO) {
-        log(LogLevel::INFO, message);
-    }
-}
-
-void Logger::warning(const std::string& message) {
-    if (currentLevel <= LogLevel::WARNING) {
-        log(LogLevel::WARNING, message);
-    }
-}
-
-void Logger::error(const std::string& message) {
-    if (currentLevel <= LogLevel::ERROR) {
-        log(LogLevel::ERROR, message);
-    }
-}
-
-void Logger::log(LogLevel level, const std::string& message) {
-    std::lock_guard<std::mutex> lock(logMutex);
-    
-    std::string logEntry = "[" + getCurrentTime() + "] [" + levelToString(level) + "] " + message;
-    
-    // Always print to console
-    if (level >= LogLevel::WARNING) {
-        std::cerr << logEntry << std::endl;
-    } else {
-        std::cout << logEntry << std::endl;
-    }
-    
-    // Write to file if open
-    if (logFile.is_open()) {
-        logFile << logEntry << std::endl;
-        logFile.flush();
-    }
-}
\ No newline at end of file
+// src/utils/Logger.cpp
+#include "Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+std::atomic<LogLevel> Logger::currentLevel(LogLevel::INFO);
+
+namespace {
+
+struct LogRecord {
+    std::chrono::system_clock::time_point time;
+    LogLevel level = LogLevel::INFO;
+    std::string message;
+};
+
+// Single-producer ring: only the owning thread pushes and only the writer
+// thread drains, so neither side ever takes a lock.
+class LogRing {
+public:
+    static constexpr size_t CAPACITY = 4096;
+
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<bool> retired{false};   // Owning thread has exited
+
+    LogRing() : slots(CAPACITY) {}
+
+    bool push(LogRecord& record) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == CAPACITY) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        slots[t & (CAPACITY - 1)] = std::move(record);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producer side: how full the ring is, to decide whether to wake the writer
+    size_t size() const {
+        return tail.load(std::memory_order_relaxed) - head.load(std::memory_order_acquire);
+    }
+
+    void drain(std::vector<LogRecord>& out) {
+        size_t h = head.load(std::memory_order_relaxed);
+        size_t t = tail.load(std::memory_order_acquire);
+        for (; h != t; ++h) {
+            out.push_back(std::move(slots[h & (CAPACITY - 1)]));
+        }
+        head.store(h, std::memory_order_release);
+    }
+
+private:
+    std::vector<LogRecord> slots;
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+};
+
+const char* levelToString(LogLevel level) {
+    switch (level) {
+        case LogLevel::DEBUG: return "DEBUG";
+        case LogLevel::INFO: return "INFO";
+        case LogLevel::WARNING: return "WARNING";
+        case LogLevel::ERROR: return "ERROR";
+        default: return "UNKNOWN";
+    }
+}
+
+// Formats "[YYYY-mm-dd HH:MM:SS] [LEVEL] message\n", reusing the time
+// string for every record within the same second
+class LineFormatter {
+private:
+    time_t cachedSecond = -1;
+    char cachedTime[32] = {};
+
+public:
+    void append(std::string& out, const LogRecord& record) {
+        time_t second = std::chrono::system_clock::to_time_t(record.time);
+        if (second != cachedSecond) {
+            struct tm local;
+            localtime_r(&second, &local);
+            strftime(cachedTime, sizeof(cachedTime), "%Y-%m-%d %H:%M:%S", &local);
+            cachedSecond = second;
+        }
+        out += '[';
+        out += cachedTime;
+        out += "] [";
+        out += levelToString(record.level);
+        out += "] ";
+        out += record.message;
+        out += '\n';
+    }
+};
+
+class LogWriter {
+public:
+    ~LogWriter() { stop(); }
+
+    void open(const std::string& filename) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!filename.empty()) {
+            logFile.open(filename, std::ios::app);
+            if (!logFile.is_open()) {
+                std::cerr << "Warning: Cannot open log file: " << filename << std::endl;
+            }
+        }
+        if (!running.exchange(true)) {
+            thread = std::thread(&LogWriter::run, this);
+        }
+    }
+
+    void stop() {
+        if (running.exchange(false)) {
+            wake.notify_one();
+            thread.join();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (logFile.is_open()) {
+            logFile.close();
+        }
+    }
+
+    void log(LogLevel level, std::string message) {
+        LogRecord record{std::chrono::system_clock::now(), level, std::move(message)};
+        if (!running.load(std::memory_order_acquire)) {
+            writeNow(record);
+            return;
+        }
+
+        LogRing& ring = localRing();
+        ring.push(record);
+
+        // Batches are flushed on a timer; only a filling ring or an error
+        // is worth waking the writer early
+        if ((ring.size() >= LogRing::CAPACITY / 2 || level == LogLevel::ERROR) &&
+            !wakeRequested.exchange(true, std::memory_order_relaxed)) {
+            wake.notify_one();
+        }
+    }
+
+    uint64_t getDroppedCount() const { return totalDropped.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr std::chrono::milliseconds FLUSH_INTERVAL{50};
+
+    struct RingHandle {
+        std::shared_ptr<LogRing> ring;
+        ~RingHandle() {
+            if (ring) {
+                ring->retired.store(true, std::memory_order_release);
+            }
+        }
+    };
+
+    std::mutex mutex;       // Guards the ring list, the file, and synchronous writes
+    std::condition_variable wake;
+    std::vector<std::shared_ptr<LogRing>> rings;
+    std::ofstream logFile;
+    std::thread thread;
+    std::atomic<bool> running{false};
+    std::atomic<bool> wakeRequested{false};
+    std::atomic<uint64_t> totalDropped{0};
+
+    // Only touched by the writer thread
+    std::vector<LogRecord> batch;
+    LineFormatter formatter;
+
+    LogRing& localRing() {
+        thread_local RingHandle handle;
+        if (!handle.ring) {
+            handle.ring = std::make_shared<LogRing>();
+            std::lock_guard<std::mutex> lock(mutex);
+            rings.push_back(handle.ring);
+        }
+        return *handle.ring;
+    }
+
+    void run() {
+        while (running.load(std::memory_order_acquire)) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait_for(lock, FLUSH_INTERVAL, [this]() {
+                    return wakeRequested.load(std::memory_order_relaxed) ||
+                           !running.load(std::memory_order_relaxed);
+                });
+            }
+            wakeRequested.store(false, std::memory_order_relaxed);
+            flush();
+        }
+        flush();
+    }
+
+    void flush() {
+        std::vector<std::shared_ptr<LogRing>> snapshot;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            snapshot = rings;
+        }
+
+        uint64_t dropped = 0;
+        bool anyRetired = false;
+        for (const auto& ring : snapshot) {
+            // A ring retired before this drain has nothing more coming
+            bool retired = ring->retired.load(std::memory_order_acquire);
+            ring->drain(batch);
+            dropped += ring->dropped.exchange(0, std::memory_order_relaxed);
+            anyRetired = anyRetired || retired;
+        }
+
+        if (dropped > 0) {
+            totalDropped.fetch_add(dropped, std::memory_order_relaxed);
+            batch.push_back({std::chrono::system_clock::now(), LogLevel::WARNING,
+                             std::to_string(dropped) + " log messages dropped, logger falling behind"});
+        }
+
+        if (!batch.empty()) {
+            // Rings are drained one after another; restore the global order
+            std::stable_sort(batch.begin(), batch.end(),
+                             [](const LogRecord& a, const LogRecord& b) { return a.time < b.time; });
+            std::string all;
+            std::string out;
+            std::string err;
+            for (const auto& record : batch) {
+                size_t start = all.size();
+                formatter.append(all, record);
+                (record.level >= LogLevel::WARNING ? err : out).append(all, start, std::string::npos);
+            }
+            batch.clear();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            writeBlocks(out, err, all);
+        }
+
+        if (anyRetired) {
+            std::lock_guard<std::mutex> lock(mutex);
+            rings.erase(std::remove_if(rings.begin(), rings.end(),
+                                       [&](const std::shared_ptr<LogRing>& ring) {
+                                           return ring->retired.load(std::memory_order_acquire) &&
+                                                  ring->size() == 0;
+                                       }),
+                        rings.end());
+        }
+    }
+
+    // Used before the writer starts and after it stops
+    void writeNow(const LogRecord& record) {
+        std::string line;
+        std::lock_guard<std::mutex> lock(mutex);
+        LineFormatter oneShot;
+        oneShot.append(line, record);
+        bool isError = record.level >= LogLevel::WARNING;
+        writeBlocks(isError ? std::string() : line, isError ? line : std::string(), line);
+    }
+
+    // Caller holds mutex
+    void writeBlocks(const std::string& out, const std::string& err, const std::string& all) {
+        if (!out.empty()) {
+            std::cout.write(out.data(), static_cast<std::streamsize>(out.size()));
+            std::cout.flush();
+        }
+        if (!err.empty()) {
+            std::cerr.write(err.data(), static_cast<std::streamsize>(err.size()));
+        }
+        if (logFile.is_open() && !all.empty()) {
+            logFile.write(all.data(), static_cast<std::streamsize>(all.size()));
+            logFile.flush();
+        }
+    }
+};
+
+LogWriter& writer() {
+    static LogWriter instance;
+    return instance;
+}
+
+} // namespace
+
+void Logger::init(const std::string& filename, LogLevel level) {
+    setLogLevel(level);
+    writer().open(filename);
+}
+
+void Logger::close() {
+    writer().stop();
+}
+
+void Logger::log(LogLevel level, std::string message) {
+    writer().log(level, std::move(message));
+}
+
+uint64_t Logger::getDroppedCount() {
+    return writer().getDroppedCount();
+}
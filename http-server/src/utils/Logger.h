@@ -1,36 +1,58 @@
-// src/utils/Logger.h
-#pragma once
-#include <string>
-#include <fstream>
-#include <iostream>
-#include <mutex>
-#include <chrono>
-#include <iomanip>
-
-enum class LogLevel {
-    DEBUG,
-    INFO,
-    WARNING,
-    ERROR
-};
-
-class Logger {
-private:
-    static std::ofstream logFile;
-    static LogLevel currentLevel;
-    static std::mutex logMutex;
-    
-    static std::string levelToString(LogLevel level);
-    static std::string getCurrentTime();
-    
-public:
-    static void init(const std::string& filename = "", LogLevel level = LogLevel::INFO);
-    static void close();
-    
-    static void debug(const std::string& message);
-    static void info(const std::string& message);
-    static void warning(const std::string& message);
-    static void error(const std::string& message);
-    
-    static void setLogLevel(LogLevel level) { currentLevel = level; }
-};
\ No newline at end of file
+// src/utils/Logger.h
+#pragma once
+#include <string>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+enum class LogLevel {
+    DEBUG,
+    INFO,
+    WARNING,
+    ERROR
+};
+
+// Asynchronous logger. Each thread appends records to its own lock-free
+// ring, and a background thread drains every ring and writes them out in
+// batches. A thread whose ring is full drops the record and counts it
+// rather than waiting for the writer. Before init() and after close()
+// records are written synchronously.
+//
+// Every level also takes a callable returning the message, which is only
+// invoked when the level is enabled:
+//     Logger::debug([&] { return "New connection from: " + clientIP; });
+class Logger {
+private:
+    static std::atomic<LogLevel> currentLevel;
+
+    static void log(LogLevel level, std::string message);
+
+    template <typename Fn>
+    using IfMessageBuilder = std::enable_if_t<std::is_invocable_r_v<std::string, Fn>>;
+
+public:
+    static void init(const std::string& filename = "", LogLevel level = LogLevel::INFO);
+    static void close();
+
+    static bool isEnabled(LogLevel level) { return currentLevel.load(std::memory_order_relaxed) <= level; }
+
+    static void debug(std::string message) { if (isEnabled(LogLevel::DEBUG)) log(LogLevel::DEBUG, std::move(message)); }
+    static void info(std::string message) { if (isEnabled(LogLevel::INFO)) log(LogLevel::INFO, std::move(message)); }
+    static void warning(std::string message) { if (isEnabled(LogLevel::WARNING)) log(LogLevel::WARNING, std::move(message)); }
+    static void error(std::string message) { if (isEnabled(LogLevel::ERROR)) log(LogLevel::ERROR, std::move(message)); }
+
+    template <typename Fn, typename = IfMessageBuilder<Fn>>
+    static void debug(Fn&& makeMessage) { if (isEnabled(LogLevel::DEBUG)) log(LogLevel::DEBUG, makeMessage()); }
+    template <typename Fn, typename = IfMessageBuilder<Fn>>
+    static void info(Fn&& makeMessage) { if (isEnabled(LogLevel::INFO)) log(LogLevel::INFO, makeMessage()); }
+    template <typename Fn, typename = IfMessageBuilder<Fn>>
+    static void warning(Fn&& makeMessage) { if (isEnabled(LogLevel::WARNING)) log(LogLevel::WARNING, makeMessage()); }
+    template <typename Fn, typename = IfMessageBuilder<Fn>>
+    static void error(Fn&& makeMessage) { if (isEnabled(LogLevel::ERROR)) log(LogLevel::ERROR, makeMessage()); }
+
+    static void setLogLevel(LogLevel level) { currentLevel.store(level, std::memory_order_relaxed); }
+
+    // Records dropped because a thread's ring was full
+    static uint64_t getDroppedCount();
+};